@@ -2,28 +2,41 @@
 #include "software-i2c.h"
 #include "display.h"
 #include "awakening.h"
+#include "scheduler.h"
 
 static Display<128, 64> display;
 static SoftwareI2c<20, 21> i2c;
-static Ssd1306<decltype(i2c)> ssd{i2c};
+static Ssd1306<I2cTransport<decltype(i2c)>, true> ssd{i2c};
+static Scheduler<decltype(ssd), decltype(display)> scheduler{ssd, display};
+
+static AWAKENING_PRERENDER(LINE1, "Hier könnte Ihre", Awakening::CENTER);
+static AWAKENING_PRERENDER(LINE2, "Werbung stehen!", Awakening::CENTER);
+static AWAKENING_PRERENDER(LINE3, "Comment ça va?", Awakening::CENTER);
+static AWAKENING_PRERENDER(LINE4, "120kΩ 1769", Awakening::CENTER);
+
+// The parts of the screen for the scheduler.
+static constexpr unsigned char TEXT = 1;
+
+static void render(decltype(display) &d, unsigned char dirty) {
+  if (dirty & TEXT) {
+    d.clear();
+    LINE1.draw(d, 0, 2, 128);
+    LINE2.draw(d, 0, 14, 128);
+    LINE3.draw(d, 0, 26, 128);
+    LINE4.draw(d, 0, 40, 128);
+    //d.line(0, 0, 128, 64);
+  }
+}
 
 void setup() {
   // put your setup code here, to run once:
   pinMode(LED_BUILTIN, OUTPUT);
   ssd.init();
+  scheduler.invalidate(TEXT);
 }
 
 void loop() {
   // put your main code here, to run repeatedly:
-  display.clear();
-  Awakening::text_centered(display, "Hier könnte Ihre", 0, 2, 128);
-  Awakening::text_centered(display, "Werbung stehen!", 0, 14, 128);
-  Awakening::text_centered(display, "Comment ça va?", 0, 26, 128);
-  Awakening::text_centered(display, "120kΩ 1769", 0, 40, 128);
-  //display.line(0, 0, 128, 64);
-  ssd.display(display.data());
-  digitalWrite(LED_BUILTIN, HIGH);
-  delay(500);
-  digitalWrite(LED_BUILTIN, LOW);
-  delay(500);
+  digitalWrite(LED_BUILTIN, millis() % 1000 < 500 ? HIGH : LOW);
+  scheduler.run(render);
 }
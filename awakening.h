@@ -1,6 +1,8 @@
 #pragma once
 
-// Fonts are an array of unsigned char.
+#include "flash.h"
+
+// Fonts are an array of unsigned char in program memory, read with `flash_byte`.
 // Every glyph is a pair of an UTF-8 string and the glyph bitmap.
 // They are encoded by a one byte size, the string, another one byte size and the bitmap data.
 // The most significant bit of the bitmap size encodes if the glyph is 16 pixels high. If this
@@ -9,6 +11,11 @@
 // The bitmap data is one byte per column for 8 pixel high glyphs and two bytes per column
 // for 16 pixel high glyphs. The least significant bit represents the topmost row.
 //
+// The text size is in the low four bits. The high four bits are zero for 8 pixel high glyphs
+// at rows 4 to 11 of the 16 pixel line. Otherwise they are one more than the first row of
+// the 8 pixel high glyph, so glyphs which are placed higher or lower do not need two bytes
+// per column.
+//
 // A font looks like this:
 // +-------+-------+-----+---+
 // | Glyph | Glyph | ... | 0 |
@@ -20,36 +27,279 @@
 // +-----------+------+-------------+--------+
 //    1 Byte    m Bytes   1 Byte      n Bytes
 //
-// In addition to that a font can have an index. The index is an array of 64 signed integers
-// which represent the offset into the font data where one should begin searching for a glyph.
-// To calculate the index in the array, the first byte of the string is shifted to the right by two.
+// tools/fontc.py compiles BDF and PNG fonts into glyphs for this table.
+//
+// The index of a font holds the offsets of all glyphs sorted by their text. It is generated
+// by tools/fontc.py --index and checked at compile time, and lets `lookup_glyph` find the
+// longest matching glyph with a binary search. It lives in program memory as well.
+
+static constexpr unsigned char AWAKENING_GLYPHS[] FLASH = {
+  /* "\t" */ 1, 9, 8, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* "\e1" */ 2, 27, 49, 3, 34, 63, 32,
+  /* "\ed" */ 2, 27, 100, 5, 16, 48, 112, 48, 16,
+  /* "\el" */ 2, 27, 108, 3, 8, 28, 62,
+  /* "\er" */ 2, 27, 114, 3, 62, 28, 8,
+  /* "\eud" */ 3, 27, 117, 100, 5, 20, 54, 119, 54, 20,
+  /* "\eu" */ 2, 27, 117, 5, 4, 6, 7, 6, 4,
+  /* "!" */ 1, 33, 1, 46,
+  /* "\"" */ 1, 34, 3, 3, 0, 3,
+  /* "#" */ 1, 35, 5, 20, 62, 20, 62, 20,
+  /* "$" */ 1, 36, 5, 36, 42, 107, 42, 18,
+  /* "%" */ 1, 37, 5, 34, 16, 8, 4, 34,
+  /* "&" */ 1, 38, 5, 20, 42, 42, 20, 40,
+  /* "'" */ 1, 39, 1, 3,
+  /* "(" */ 1, 40, 2, 62, 65,
+  /* ")" */ 1, 41, 2, 65, 62,
+  /* "+" */ 1, 43, 5, 8, 8, 62, 8, 8,
+  /* "," */ 1, 44, 2, 64, 32,
+  /* "-" */ 1, 45, 4, 8, 8, 8, 8,
+  /* "." */ 1, 46, 1, 32,
+  /* "/" */ 1, 47, 5, 32, 16, 8, 4, 2,
+  /* "0" */ 1, 48, 5, 30, 33, 33, 33, 30,
+  /* "1" */ 1, 49, 3, 34, 63, 32,
+  /* "2" */ 1, 50, 5, 34, 49, 41, 41, 38,
+  /* "3" */ 1, 51, 5, 18, 33, 33, 37, 26,
+  /* "4" */ 1, 52, 5, 24, 20, 18, 63, 16,
+  /* "5" */ 1, 53, 5, 23, 37, 37, 37, 25,
+  /* "6" */ 1, 54, 5, 28, 38, 37, 37, 24,
+  /* "7" */ 1, 55, 5, 1, 1, 57, 5, 3,
+  /* "8" */ 1, 56, 5, 26, 37, 37, 37, 26,
+  /* "9" */ 1, 57, 5, 6, 73, 41, 25, 14,
+  /* ":" */ 1, 58, 1, 20,
+  /* ";" */ 1, 59, 2, 64, 40,
+  /* "<" */ 1, 60, 3, 8, 20, 34,
+  /* "=" */ 1, 61, 3, 20, 20, 20,
+  /* ">" */ 1, 62, 3, 34, 20, 8,
+  /* "?" */ 1, 63, 5, 4, 2, 42, 10, 4,
+  /* "@" */ 1, 64, 7, 62, 65, 93, 85, 93, 81, 14,
+  /* "A" */ 1, 65, 5, 62, 9, 9, 9, 62,
+  /* "B" */ 1, 66, 5, 63, 37, 37, 37, 26,
+  /* "C" */ 1, 67, 5, 30, 33, 33, 33, 34,
+  /* "D" */ 1, 68, 5, 63, 33, 33, 34, 28,
+  /* "E" */ 1, 69, 5, 63, 37, 37, 37, 33,
+  /* "F" */ 1, 70, 5, 63, 5, 5, 5, 1,
+  /* "G" */ 1, 71, 5, 28, 34, 33, 41, 58,
+  /* "H" */ 1, 72, 5, 63, 4, 4, 4, 63,
+  /* "I" */ 1, 73, 3, 33, 63, 33,
+  /* "J" */ 1, 74, 5, 16, 32, 32, 33, 31,
+  /* "K" */ 1, 75, 5, 63, 0, 12, 18, 33,
+  /* "L" */ 1, 76, 5, 63, 32, 32, 32, 32,
+  /* "M" */ 1, 77, 5, 63, 2, 4, 2, 63,
+  /* "N" */ 1, 78, 5, 63, 6, 12, 24, 63,
+  /* "O" */ 1, 79, 5, 30, 33, 33, 33, 30,
+  /* "P" */ 1, 80, 5, 63, 9, 9, 9, 6,
+  /* "Q" */ 1, 81, 5, 30, 33, 41, 17, 46,
+  /* "R" */ 1, 82, 5, 63, 5, 13, 21, 34,
+  /* "S" */ 1, 83, 5, 18, 37, 37, 37, 24,
+  /* "T" */ 1, 84, 5, 1, 1, 63, 1, 1,
+  /* "U" */ 1, 85, 5, 31, 32, 32, 32, 31,
+  /* "V" */ 1, 86, 5, 15, 16, 32, 16, 15,
+  /* "W" */ 1, 87, 5, 63, 16, 8, 16, 63,
+  /* "X" */ 1, 88, 5, 33, 18, 12, 18, 33,
+  /* "Y" */ 1, 89, 5, 3, 4, 56, 4, 3,
+  /* "Z" */ 1, 90, 5, 33, 49, 45, 35, 33,
+  /* "[" */ 1, 91, 2, 127, 65,
+  /* "\\" */ 1, 92, 5, 2, 4, 8, 16, 32,
+  /* "]" */ 1, 93, 2, 65, 127,
+  /* "_" */ 1, 95, 4, 32, 32, 32, 32,
+  /* "a" */ 1, 97, 5, 16, 42, 42, 42, 60,
+  /* "b" */ 1, 98, 5, 63, 36, 34, 34, 28,
+  /* "c" */ 1, 99, 5, 28, 34, 34, 34, 36,
+  /* "d" */ 1, 100, 5, 28, 34, 34, 36, 63,
+  /* "e" */ 1, 101, 5, 28, 42, 42, 42, 12,
+  /* "ff" */ 2, 102, 102, 7, 8, 126, 9, 9, 126, 9, 1,
+  /* "f" */ 1, 102, 4, 8, 126, 9, 1,
+  /* "g" */ 1, 103, 5, 24, 164, 162, 146, 126,
+  /* "h" */ 1, 104, 5, 63, 4, 2, 2, 60,
+  /* "i" */ 1, 105, 2, 4, 61,
+  /* "j" */ 1, 106, 3, 128, 132, 125,
+  /* "k" */ 1, 107, 4, 63, 8, 20, 34,
+  /* "l" */ 1, 108, 2, 1, 63,
+  /* "m" */ 1, 109, 5, 62, 4, 8, 4, 62,
+  /* "n" */ 1, 110, 5, 62, 2, 2, 4, 56,
+  /* "o" */ 1, 111, 5, 28, 34, 34, 34, 28,
+  /* "p" */ 1, 112, 5, 254, 34, 34, 36, 24,
+  /* "q" */ 1, 113, 5, 24, 36, 34, 34, 254,
+  /* "r" */ 1, 114, 4, 62, 4, 2, 2,
+  /* "s" */ 1, 115, 5, 36, 42, 42, 42, 16,
+  /* "t" */ 1, 116, 4, 2, 31, 34, 32,
+  /* "u" */ 1, 117, 5, 14, 16, 32, 32, 62,
+  /* "v" */ 1, 118, 5, 14, 16, 32, 16, 14,
+  /* "w" */ 1, 119, 5, 62, 16, 8, 16, 62,
+  /* "x" */ 1, 120, 5, 34, 20, 8, 20, 34,
+  /* "y" */ 1, 121, 5, 142, 144, 144, 72, 62,
+  /* "z" */ 1, 122, 5, 34, 50, 42, 38, 34,
+  /* "{" */ 1, 123, 3, 8, 54, 65,
+  /* "|" */ 1, 124, 1, 127,
+  /* "}" */ 1, 125, 3, 65, 54, 8,
+  /* "¡" */ 2, 194, 161, 1, 116,
+  /* "©" */ 2, 194, 169, 8, 30, 33, 12, 18, 18, 20, 33, 30,
+  /* "«" */ 2, 194, 171, 4, 8, 20, 8, 20,
+  /* "°" */ 2, 194, 176, 3, 7, 5, 7,
+  /* "µ" */ 2, 194, 181, 5, 254, 16, 32, 32, 62,
+  /* "»" */ 2, 194, 187, 4, 20, 8, 20, 8,
+  /* "¿" */ 2, 194, 191, 5, 32, 80, 84, 64, 32,
+  /* "À" */ 2, 195, 128, 138, 224, 3, 146, 0, 148, 0, 144, 0, 224, 3,
+  /* "Á" */ 2, 195, 129, 138, 224, 3, 144, 0, 148, 0, 146, 0, 224, 3,
+  /* "Â" */ 2, 195, 130, 138, 224, 3, 148, 0, 146, 0, 148, 0, 224, 3,
+  /* "Ä" */ 50, 195, 132, 5, 248, 37, 36, 37, 248,
+  /* "Æ" */ 2, 195, 134, 9, 62, 9, 9, 9, 63, 37, 37, 37, 33,
+  /* "Ç" */ 2, 195, 135, 5, 30, 161, 225, 33, 18,
+  /* "È" */ 2, 195, 136, 138, 240, 3, 82, 2, 84, 2, 80, 2, 16, 2,
+  /* "É" */ 2, 195, 137, 138, 240, 3, 80, 2, 84, 2, 82, 2, 16, 2,
+  /* "Ê" */ 2, 195, 138, 138, 240, 3, 84, 2, 82, 2, 84, 2, 16, 2,
+  /* "Ë" */ 50, 195, 139, 5, 252, 149, 148, 149, 132,
+  /* "Í" */ 2, 195, 141, 134, 16, 2, 244, 3, 18, 2,
+  /* "Î" */ 2, 195, 142, 134, 20, 2, 242, 3, 20, 2,
+  /* "Ï" */ 50, 195, 143, 3, 133, 252, 133,
+  /* "Ð" */ 2, 195, 144, 6, 8, 63, 41, 33, 34, 28,
+  /* "Ñ" */ 2, 195, 145, 138, 240, 3, 100, 0, 194, 0, 132, 1, 242, 3,
+  /* "Ó" */ 2, 195, 147, 138, 224, 1, 16, 2, 20, 2, 18, 2, 224, 1,
+  /* "Ô" */ 2, 195, 148, 138, 224, 1, 20, 2, 18, 2, 20, 2, 224, 1,
+  /* "Ö" */ 50, 195, 150, 5, 120, 133, 132, 133, 120,
+  /* "Ù" */ 50, 195, 153, 5, 124, 129, 130, 128, 124,
+  /* "Ú" */ 50, 195, 154, 5, 124, 128, 130, 129, 124,
+  /* "Û" */ 2, 195, 155, 138, 240, 1, 4, 2, 2, 2, 4, 2, 240, 1,
+  /* "Ü" */ 50, 195, 156, 5, 124, 129, 128, 129, 124,
+  /* "Ý" */ 50, 195, 157, 5, 12, 16, 226, 17, 12,
+  /* "Þ" */ 2, 195, 158, 4, 63, 18, 18, 12,
+  /* "ß" */ 2, 195, 159, 4, 62, 1, 41, 22,
+  /* "à" */ 50, 195, 160, 5, 64, 169, 170, 168, 240,
+  /* "á" */ 50, 195, 161, 5, 64, 168, 170, 169, 240,
+  /* "â" */ 50, 195, 162, 5, 64, 170, 169, 170, 240,
+  /* "ä" */ 66, 195, 164, 5, 32, 85, 84, 85, 120,
+  /* "æ" */ 2, 195, 166, 9, 16, 42, 42, 42, 60, 42, 42, 42, 12,
+  /* "ç" */ 2, 195, 167, 5, 28, 162, 226, 34, 36,
+  /* "è" */ 50, 195, 168, 5, 112, 169, 170, 168, 48,
+  /* "é" */ 50, 195, 169, 5, 112, 168, 170, 169, 48,
+  /* "ê" */ 50, 195, 170, 5, 112, 170, 169, 170, 48,
+  /* "ë" */ 66, 195, 171, 5, 56, 85, 84, 85, 24,
+  /* "í" */ 66, 195, 173, 2, 10, 121,
+  /* "î" */ 66, 195, 174, 3, 10, 121, 2,
+  /* "ï" */ 2, 195, 175, 3, 5, 60, 1,
+  /* "ð" */ 66, 195, 176, 5, 48, 73, 77, 74, 61,
+  /* "ñ" */ 50, 195, 177, 5, 248, 10, 9, 18, 225,
+  /* "ó" */ 50, 195, 179, 5, 112, 136, 138, 137, 112,
+  /* "ô" */ 50, 195, 180, 5, 112, 138, 137, 138, 112,
+  /* "ö" */ 66, 195, 182, 5, 56, 69, 68, 69, 56,
+  /* "ù" */ 66, 195, 185, 5, 28, 33, 66, 64, 124,
+  /* "ú" */ 66, 195, 186, 5, 28, 32, 66, 65, 124,
+  /* "û" */ 50, 195, 187, 5, 56, 66, 129, 130, 248,
+  /* "ü" */ 66, 195, 188, 5, 28, 33, 64, 65, 124,
+  /* "ý" */ 2, 195, 189, 138, 224, 8, 0, 9, 16, 9, 136, 4, 224, 3,
+  /* "þ" */ 2, 195, 190, 5, 255, 36, 34, 34, 28,
+  /* "Œ" */ 2, 197, 146, 9, 30, 33, 33, 33, 63, 37, 37, 37, 33,
+  /* "œ" */ 2, 197, 147, 9, 28, 34, 34, 34, 28, 42, 42, 42, 12,
+  /* "Ω" */ 2, 206, 169, 5, 46, 49, 1, 49, 46,
+  /* "‘" */ 3, 226, 128, 152, 2, 6, 5,
+  /* "’" */ 3, 226, 128, 153, 2, 5, 3,
+  /* "‚" */ 3, 226, 128, 154, 2, 80, 48,
+  /* "“" */ 3, 226, 128, 156, 5, 6, 5, 0, 6, 5,
+  /* "”" */ 3, 226, 128, 157, 5, 5, 3, 0, 5, 3,
+  /* "„" */ 3, 226, 128, 158, 5, 80, 48, 0, 80, 48,
+  /* "…" */ 3, 226, 128, 166, 5, 32, 0, 32, 0, 32,
+  0
+};
+// The offsets of the glyphs sorted by their text, from tools/fontc.py --index.
+static constexpr short AWAKENING_INDEX[] FLASH = {
+  0, 11, 18, 27, 34, 51, 41, 60, 64, 70, 78, 86,
+  94, 102, 106, 111, 116, 124, 129, 136, 140, 148, 156, 162,
+  170, 178, 186, 194, 202, 210, 218, 226, 230, 235, 241, 247,
+  253, 261, 271, 279, 287, 295, 303, 311, 319, 327, 335, 341,
+  349, 357, 365, 373, 381, 389, 397, 405, 413, 421, 429, 437,
+  445, 453, 461, 469, 477, 482, 490, 495, 502, 510, 518, 526,
+  534, 553, 542, 560, 568, 576, 581, 587, 594, 599, 607, 615,
+  623, 631, 639, 646, 654, 661, 669, 677, 685, 693, 701, 709,
+  715, 719, 725, 730, 742, 750, 757, 766, 774, 783, 797, 811,
+  825, 834, 847, 856, 870, 884, 898, 907, 917, 927, 934, 944,
+  958, 972, 986, 995, 1004, 1013, 1027, 1036, 1045, 1053, 1061, 1070,
+  1079, 1088, 1097, 1110, 1119, 1128, 1137, 1146, 1155, 1161, 1168, 1175,
+  1184, 1193, 1202, 1211, 1220, 1229, 1238, 1247, 1256, 1270, 1279, 1292,
+  1305, 1314, 1321, 1328, 1335, 1345, 1355, 1365,
+};
+
+// The size of the glyph at offset o.
+template<int SIZE>
+constexpr int font_glyph_length(const unsigned char (&font)[SIZE], int o) {
+  return (font[o] & 0x0f) + (font[o + (font[o] & 0x0f) + 1] & 0x7f) + 2;
+}
+
+// Compare the texts of the glyphs at offsets a and b from byte i on.
+template<int SIZE>
+constexpr int font_compare(const unsigned char (&font)[SIZE], int a, int b, int i = 0) {
+  return i < (font[a] & 0x0f) && i < (font[b] & 0x0f) ?
+    (font[a + 1 + i] != font[b + 1 + i] ? font[a + 1 + i] - font[b + 1 + i] : font_compare(font, a, b, i + 1)) :
+    (font[a] & 0x0f) - (font[b] & 0x0f);
+}
+
+// If the glyphs between i and j of an index are sorted by their text.
+template<int SIZE, int N>
+constexpr bool font_sorted(const unsigned char (&font)[SIZE], const short (&index)[N], int i, int j) {
+  return j - i < 2 || (font_sorted(font, index, i, (i + j) / 2) &&
+                       font_compare(font, index[(i + j) / 2 - 1], index[(i + j) / 2]) < 0 &&
+                       font_sorted(font, index, (i + j) / 2, j));
+}
+
+// The size of the glyphs between i and j of an index together.
+template<int SIZE, int N>
+constexpr int font_indexed(const unsigned char (&font)[SIZE], const short (&index)[N], int i, int j) {
+  return j - i < 2 ? (j > i ? font_glyph_length(font, index[i]) : 0) :
+    font_indexed(font, index, i, (i + j) / 2) + font_indexed(font, index, (i + j) / 2, j);
+}
+
+static_assert(font_sorted(AWAKENING_GLYPHS, AWAKENING_INDEX, 0, sizeof(AWAKENING_INDEX) / sizeof(short)) &&
+              font_indexed(AWAKENING_GLYPHS, AWAKENING_INDEX, 0, sizeof(AWAKENING_INDEX) / sizeof(short)) + 1 ==
+                sizeof(AWAKENING_GLYPHS),
+              "The index does not match the glyphs, run tools/fontc.py awakening.h --index");
 
 class Awakening {
-    static int TEXT_LENGTH(const unsigned char *glyph) {
-      return glyph[0];
+    // The accessors read the font from program memory, or directly when `flash` is false,
+    // which is only right at compile time.
+    template<bool flash>
+    static constexpr unsigned char READ(const unsigned char *p) {
+      return flash ? flash_byte(p) : *p;
+    }
+    template<bool flash>
+    static constexpr short READ(const short *p) {
+      return flash ? flash_short(p) : *p;
     }
-    static const unsigned char *TEXT(const unsigned char *glyph) {
+    template<bool flash = true>
+    static constexpr int TEXT_LENGTH(const unsigned char *glyph) {
+      return READ<flash>(glyph) & 0x0f;
+    }
+    // The row of the 16 pixel line where an 8 pixel high glyph starts.
+    template<bool flash = true>
+    static constexpr int GLYPH_TOP(const unsigned char *glyph) {
+      return READ<flash>(glyph) >> 4 ? (READ<flash>(glyph) >> 4) - 1 : 4;
+    }
+    static constexpr const unsigned char *TEXT(const unsigned char *glyph) {
       return glyph + 1;
     }
-    static int GLYPH_LENGTH(const unsigned char *glyph) {
-      return glyph[TEXT_LENGTH(glyph) + 1] & 0x7f;
+    template<bool flash = true>
+    static constexpr int GLYPH_LENGTH(const unsigned char *glyph) {
+      return READ<flash>(glyph + TEXT_LENGTH<flash>(glyph) + 1) & 0x7f;
     }
-    static bool GLYPH_FULLSIZE(const unsigned char *glyph) {
-      return glyph[TEXT_LENGTH(glyph) + 1] & 0x80;
+    template<bool flash = true>
+    static constexpr bool GLYPH_FULLSIZE(const unsigned char *glyph) {
+      return READ<flash>(glyph + TEXT_LENGTH<flash>(glyph) + 1) & 0x80;
     }
-    static const unsigned char *GLYPH(const unsigned char *glyph) {
-      return glyph + TEXT_LENGTH(glyph) + 2;
+    template<bool flash = true>
+    static constexpr const unsigned char *GLYPH(const unsigned char *glyph) {
+      return glyph + TEXT_LENGTH<flash>(glyph) + 2;
     }
-    static unsigned GLYPH_COL(const unsigned char *glyph, int i) {
-      return GLYPH_FULLSIZE(glyph) ?
-        (((unsigned) GLYPH(glyph)[2 * i + 1] << 8) | GLYPH(glyph)[2 * i]) :
-        ((unsigned) GLYPH(glyph)[i] << 4);
+    template<bool flash = true>
+    static constexpr unsigned GLYPH_COL(const unsigned char *glyph, int i) {
+      return GLYPH_FULLSIZE<flash>(glyph) ?
+        (((unsigned) READ<flash>(GLYPH<flash>(glyph) + 2 * i + 1) << 8) | READ<flash>(GLYPH<flash>(glyph) + 2 * i)) :
+        ((unsigned) READ<flash>(GLYPH<flash>(glyph) + i) << GLYPH_TOP<flash>(glyph));
     }
-    static int GLYPH_COLS(const unsigned char *glyph) {
-      return GLYPH_LENGTH(glyph) >> GLYPH_FULLSIZE(glyph);
+    template<bool flash = true>
+    static constexpr int GLYPH_COLS(const unsigned char *glyph) {
+      return GLYPH_LENGTH<flash>(glyph) >> GLYPH_FULLSIZE<flash>(glyph);
     }
-    static int LENGTH(const unsigned char *glyph) {
-      return TEXT_LENGTH(glyph) + GLYPH_LENGTH(glyph) + 2;
+    template<bool flash = true>
+    static constexpr int LENGTH(const unsigned char *glyph) {
+      return TEXT_LENGTH<flash>(glyph) + GLYPH_LENGTH<flash>(glyph) + 2;
     }
     static int _min(int a, int b) {
       return a > b ? b : a;
@@ -81,31 +331,139 @@ class Awakening {
     static int text_centered(Display &d, const char *text, int x, int y, int w) {
       return text_with_options(d, text, x, y, w, CENTER);
     }
+    // A glyph placed at column `x` of a line.
+    struct Placed {
+      const unsigned char *glyph;
+      short x;
+    };
+    // A line of text which is laid out once and can then be measured, aligned and drawn
+    // any number of times. Holds up to N glyphs.
+    //
+    // `layout` only typesets the text again if the text pointer, width or options changed,
+    // so a run can be kept for every label. Call `invalidate` after changing the contents
+    // of a text buffer in place.
+    template<unsigned N = 32>
+    class Run {
+        const char *text = nullptr;
+        int w = 0, options = 0, n = 0;
+        unsigned count = 0;
+        Placed placed[N];
+      public:
+        // Lay out `text` with a maximum width of `w`. Returns false if it has more than
+        // N glyphs, then only the first N are drawn.
+        bool layout(const char *text, int w, int options) {
+          if (text != this->text || w != this->w || options != this->options) {
+            this->text = text;
+            this->w = w;
+            this->options = options;
+            count = 0;
+            n = Awakening::layout(text, w, options, [this](const unsigned char *glyph, int x) {
+              if (count < N) placed[count] = {glyph, (short) x};
+              ++count;
+            });
+          }
+          return count <= N;
+        }
+        void invalidate() {
+          text = nullptr;
+        }
+        int width() const {
+          return n;
+        }
+        // Draw the run aligned between x and x+w according to its options.
+        template<class Display>
+        int draw(Display &d, int x, int y, int w) const {
+          if (options & CENTER) {
+            x += (w - n) / 2;
+          } else if (options & RIGHT) {
+            x += w - n;
+          }
+          for (unsigned i = 0; i < count && i < N; ++i) {
+            draw_glyph(d, placed[i].glyph, x + placed[i].x, y);
+          }
+          return n;
+        }
+    };
+    // A line of text rendered at compile time into columns of 16 pixels, the same as
+    // `text_with_options` would draw it. Declare one with AWAKENING_PRERENDER.
+    template<int N>
+    struct Bitmap {
+      short columns[N > 0 ? N : 1];
+      int options;
+      constexpr int width() const {
+        return N;
+      }
+      // Draw the text aligned between x and x+w according to its options.
+      // The bitmap is read from program memory, use `draw<false>` for a copy in RAM.
+      template<bool flash = true, class Display>
+      int draw(Display &d, int x, int y, int w = 0) const {
+        int i, cols = N;
+        if (options & CENTER) {
+          x += (w - N) / 2;
+        } else if (options & RIGHT) {
+          x += w - N;
+        }
+        cols = _min(cols, (int) d.width() - x);
+        for (i = _max(0, -x); i < cols; ++i) {
+          d.blit_column(x + i, y - 4, (unsigned short) READ<flash>(columns + i));
+        }
+        return N;
+      }
+    };
+    // For AWAKENING_PRERENDER, which evaluates them at compile time. They read the font
+    // directly, which gives wrong results at run time on AVR.
+    static constexpr int prerender_width(const char *text, int options) {
+      return constant_width(Pen{text, 0, 0, false}, options);
+    }
+    template<int N>
+    static constexpr Bitmap<N> prerender(const char *text, int options) {
+      return constant_bitmap<N>(text, options, typename Sequence<N>::type());
+    }
+    // The width of the text between `text` and `end` as a line.
+    static int width(const char *text, const char *end, int options = LEFT) {
+      return layout(text, 0, options, [](const unsigned char *, int) {}, end);
+    }
+    // Typeset the text between `text` and `end` as a line, with the given set of options.
+    template<class Display>
+    static int text_range(Display &d, const char *text, const char *end, int x, int y, int w, int options) {
+      if (options & TEXT_WIDTH) {
+        return layout(text, w, options, [](const unsigned char *, int) {}, end);
+      }
+      if (options & (CENTER | RIGHT)) {
+        int n = layout(text, w, options, [](const unsigned char *, int) {}, end);
+        x += options & CENTER ? (w - n) / 2 : w - n;
+      }
+      return layout(text, w, options, [&](const unsigned char *glyph, int n) {
+        draw_glyph(d, glyph, x + n, y);
+      }, end);
+    }
     // Typeset a line of text with the given set of options.
     template<class Display>
     static int text_with_options(Display &d, const char *text, int x, int y, int w, int options) {
-      const unsigned char *glyph, *g;
-      unsigned char esc[] = {27, 0, 0};
-      int i, n = 0, r, s, q = 0, is_num, was_num = 0;
-      unsigned b = 0, t = 0;
       if (options & TEXT_WIDTH) {
-        q = 1;
-        options &= ~(RIGHT + CENTER);
+        return layout(text, w, options, [](const unsigned char *, int) {});
       }
-
-      // Handle things recursively in the alignment cases.
-      if (options & CENTER) {
-        i = text_with_options(d, text, x, y, w, options | TEXT_WIDTH);
-        options &= ~(RIGHT + CENTER);
-        return text_with_options(d, text, x + (w - i) / 2, y, i, options);
-      }
-      if (options & RIGHT) {
-        i = text_with_options(d, text, x, y, w, options | TEXT_WIDTH);
-        options &= ~(RIGHT + CENTER);
-        return text_with_options(d, text, x + w - i, y, i, options);
+      if (options & (CENTER | RIGHT)) {
+        // Align in one pass, unless the text has too many glyphs to keep them.
+        Run<> run;
+        if (run.layout(text, w, options)) return run.draw(d, x, y, w);
+        int n = layout(text, w, options, [](const unsigned char *, int) {});
+        x += options & CENTER ? (w - n) / 2 : w - n;
       }
-
-      while (*text) {
+      return layout(text, w, options, [&](const unsigned char *glyph, int n) {
+        draw_glyph(d, glyph, x + n, y);
+      });
+    }
+  private:
+    // Typeset a line of text with a maximum width of `w` and call `place(glyph, x)` for
+    // every glyph. Stop at `end`, if given. Return the width used.
+    template<class Place>
+    static int layout(const char *text, int w, int options, Place place, const char *end = nullptr) {
+      const unsigned char *glyph = nullptr, *g = nullptr;
+      unsigned char esc[] = {27, 0, 0};
+      int n = 0, cols = 0, is_num = 0, was_num = 0;
+      unsigned b = 0, t = 0;
+      while (*text && (!end || text < end)) {
         if (*text == ' ') {
           ++text;
           if (w > 0 && n + SPACE_WIDTH >= w) return n;
@@ -114,7 +472,7 @@ class Awakening {
         } else if (*text == '\b') {
           ++text;
           t = 0;
-        } else if ((glyph = lookup_glyph((const unsigned char *) text))) {
+        } else if ((glyph = lookup_glyph(text))) {
           is_num = ('0' <= *text && *text <= '9');
           if ((options & TNUM) && is_num) {
             esc[1] = *text;
@@ -142,18 +500,10 @@ class Awakening {
           if ((options & TNUM) && is_num) {
             n += (TNUM_WIDTH - GLYPH_COLS(glyph)) / 2;
           }
-          for (i = 0; i < GLYPH_COLS(glyph); ++i) {
-            b = GLYPH_COL(glyph, i);
-            if (!q && x + n >= 0 && x + n < d.width()) {
-              unsigned bit = 1;
-              for (r = y - 4; r <= y + 12; ++r) {
-                if (b & bit) d.pixel(x + n, r);
-                bit <<= 1;
-              }
-            }
-            n += 1;
-          }
-          t = b;
+          cols = GLYPH_COLS(glyph);
+          place(glyph, n);
+          t = GLYPH_COL(glyph, cols - 1);
+          n += cols;
           if ((options & TNUM) && is_num) {
             n += (TNUM_WIDTH + 1 - GLYPH_COLS(glyph)) / 2;
           }
@@ -164,204 +514,192 @@ class Awakening {
       }
       return n;
     }
-    // Lookup a glyph by text.
-    static const unsigned char *lookup_glyph(const unsigned char *text) {
-      static const unsigned char glyphs[] = {
-        /* "\t" */ 1, 9, 8, 0, 0, 0, 0, 0, 0, 0, 0,
-        /* "\e1" */ 2, 27, 49, 3, 34, 63, 32,
-        /* "\ed" */ 2, 27, 100, 5, 16, 48, 112, 48, 16,
-        /* "\el" */ 2, 27, 108, 3, 8, 28, 62,
-        /* "\er" */ 2, 27, 114, 3, 62, 28, 8,
-        /* "\eud" */ 3, 27, 117, 100, 5, 20, 54, 119, 54, 20,
-        /* "\eu" */ 2, 27, 117, 5, 4, 6, 7, 6, 4,
-        /* "!" */ 1, 33, 1, 46,
-        /* "\"" */ 1, 34, 3, 3, 0, 3,
-        /* "#" */ 1, 35, 5, 20, 62, 20, 62, 20,
-        /* "$" */ 1, 36, 5, 36, 42, 107, 42, 18,
-        /* "%" */ 1, 37, 5, 34, 16, 8, 4, 34,
-        /* "&" */ 1, 38, 5, 20, 42, 42, 20, 40,
-        /* "'" */ 1, 39, 1, 3,
-        /* "(" */ 1, 40, 2, 62, 65,
-        /* ")" */ 1, 41, 2, 65, 62,
-        /* "+" */ 1, 43, 5, 8, 8, 62, 8, 8,
-        /* "," */ 1, 44, 2, 64, 32,
-        /* "-" */ 1, 45, 4, 8, 8, 8, 8,
-        /* "." */ 1, 46, 1, 32,
-        /* "/" */ 1, 47, 5, 32, 16, 8, 4, 2,
-        /* "0" */ 1, 48, 5, 30, 33, 33, 33, 30,
-        /* "1" */ 1, 49, 3, 34, 63, 32,
-        /* "2" */ 1, 50, 5, 34, 49, 41, 41, 38,
-        /* "3" */ 1, 51, 5, 18, 33, 33, 37, 26,
-        /* "4" */ 1, 52, 5, 24, 20, 18, 63, 16,
-        /* "5" */ 1, 53, 5, 23, 37, 37, 37, 25,
-        /* "6" */ 1, 54, 5, 28, 38, 37, 37, 24,
-        /* "7" */ 1, 55, 5, 1, 1, 57, 5, 3,
-        /* "8" */ 1, 56, 5, 26, 37, 37, 37, 26,
-        /* "9" */ 1, 57, 5, 6, 73, 41, 25, 14,
-        /* ":" */ 1, 58, 1, 20,
-        /* ";" */ 1, 59, 2, 64, 40,
-        /* "<" */ 1, 60, 3, 8, 20, 34,
-        /* "=" */ 1, 61, 3, 20, 20, 20,
-        /* ">" */ 1, 62, 3, 34, 20, 8,
-        /* "?" */ 1, 63, 5, 4, 2, 42, 10, 4,
-        /* "@" */ 1, 64, 7, 62, 65, 93, 85, 93, 81, 14,
-        /* "A" */ 1, 65, 5, 62, 9, 9, 9, 62,
-        /* "B" */ 1, 66, 5, 63, 37, 37, 37, 26,
-        /* "C" */ 1, 67, 5, 30, 33, 33, 33, 34,
-        /* "D" */ 1, 68, 5, 63, 33, 33, 34, 28,
-        /* "E" */ 1, 69, 5, 63, 37, 37, 37, 33,
-        /* "F" */ 1, 70, 5, 63, 5, 5, 5, 1,
-        /* "G" */ 1, 71, 5, 28, 34, 33, 41, 58,
-        /* "H" */ 1, 72, 5, 63, 4, 4, 4, 63,
-        /* "I" */ 1, 73, 3, 33, 63, 33,
-        /* "J" */ 1, 74, 5, 16, 32, 32, 33, 31,
-        /* "K" */ 1, 75, 5, 63, 0, 12, 18, 33,
-        /* "L" */ 1, 76, 5, 63, 32, 32, 32, 32,
-        /* "M" */ 1, 77, 5, 63, 2, 4, 2, 63,
-        /* "N" */ 1, 78, 5, 63, 6, 12, 24, 63,
-        /* "O" */ 1, 79, 5, 30, 33, 33, 33, 30,
-        /* "P" */ 1, 80, 5, 63, 9, 9, 9, 6,
-        /* "Q" */ 1, 81, 5, 30, 33, 41, 17, 46,
-        /* "R" */ 1, 82, 5, 63, 5, 13, 21, 34,
-        /* "S" */ 1, 83, 5, 18, 37, 37, 37, 24,
-        /* "T" */ 1, 84, 5, 1, 1, 63, 1, 1,
-        /* "U" */ 1, 85, 5, 31, 32, 32, 32, 31,
-        /* "V" */ 1, 86, 5, 15, 16, 32, 16, 15,
-        /* "W" */ 1, 87, 5, 63, 16, 8, 16, 63,
-        /* "X" */ 1, 88, 5, 33, 18, 12, 18, 33,
-        /* "Y" */ 1, 89, 5, 3, 4, 56, 4, 3,
-        /* "Z" */ 1, 90, 5, 33, 49, 45, 35, 33,
-        /* "[" */ 1, 91, 2, 127, 65,
-        /* "\\" */ 1, 92, 5, 2, 4, 8, 16, 32,
-        /* "]" */ 1, 93, 2, 65, 127,
-        /* "_" */ 1, 95, 4, 32, 32, 32, 32,
-        /* "a" */ 1, 97, 5, 16, 42, 42, 42, 60,
-        /* "b" */ 1, 98, 5, 63, 36, 34, 34, 28,
-        /* "c" */ 1, 99, 5, 28, 34, 34, 34, 36,
-        /* "d" */ 1, 100, 5, 28, 34, 34, 36, 63,
-        /* "e" */ 1, 101, 5, 28, 42, 42, 42, 12,
-        /* "ff" */ 2, 102, 102, 7, 8, 126, 9, 9, 126, 9, 1,
-        /* "f" */ 1, 102, 4, 8, 126, 9, 1,
-        /* "g" */ 1, 103, 5, 24, 164, 162, 146, 126,
-        /* "h" */ 1, 104, 5, 63, 4, 2, 2, 60,
-        /* "i" */ 1, 105, 2, 4, 61,
-        /* "j" */ 1, 106, 3, 128, 132, 125,
-        /* "k" */ 1, 107, 4, 63, 8, 20, 34,
-        /* "l" */ 1, 108, 2, 1, 63,
-        /* "m" */ 1, 109, 5, 62, 4, 8, 4, 62,
-        /* "n" */ 1, 110, 5, 62, 2, 2, 4, 56,
-        /* "o" */ 1, 111, 5, 28, 34, 34, 34, 28,
-        /* "p" */ 1, 112, 5, 254, 34, 34, 36, 24,
-        /* "q" */ 1, 113, 5, 24, 36, 34, 34, 254,
-        /* "r" */ 1, 114, 4, 62, 4, 2, 2,
-        /* "s" */ 1, 115, 5, 36, 42, 42, 42, 16,
-        /* "t" */ 1, 116, 4, 2, 31, 34, 32,
-        /* "u" */ 1, 117, 5, 14, 16, 32, 32, 62,
-        /* "v" */ 1, 118, 5, 14, 16, 32, 16, 14,
-        /* "w" */ 1, 119, 5, 62, 16, 8, 16, 62,
-        /* "x" */ 1, 120, 5, 34, 20, 8, 20, 34,
-        /* "y" */ 1, 121, 5, 142, 144, 144, 72, 62,
-        /* "z" */ 1, 122, 5, 34, 50, 42, 38, 34,
-        /* "{" */ 1, 123, 3, 8, 54, 65,
-        /* "|" */ 1, 124, 1, 127,
-        /* "}" */ 1, 125, 3, 65, 54, 8,
-        /* "¡" */ 2, 194, 161, 1, 116,
-        /* "©" */ 2, 194, 169, 8, 30, 33, 12, 18, 18, 20, 33, 30,
-        /* "«" */ 2, 194, 171, 4, 8, 20, 8, 20,
-        /* "°" */ 2, 194, 176, 3, 7, 5, 7,
-        /* "µ" */ 2, 194, 181, 5, 254, 16, 32, 32, 62,
-        /* "»" */ 2, 194, 187, 4, 20, 8, 20, 8,
-        /* "¿" */ 2, 194, 191, 5, 32, 80, 84, 64, 32,
-        /* "À" */ 2, 195, 128, 138, 224, 3, 146, 0, 148, 0, 144, 0, 224, 3,
-        /* "Á" */ 2, 195, 129, 138, 224, 3, 144, 0, 148, 0, 146, 0, 224, 3,
-        /* "Â" */ 2, 195, 130, 138, 224, 3, 148, 0, 146, 0, 148, 0, 224, 3,
-        /* "Ä" */ 2, 195, 132, 138, 224, 3, 148, 0, 144, 0, 148, 0, 224, 3,
-        /* "Æ" */ 2, 195, 134, 9, 62, 9, 9, 9, 63, 37, 37, 37, 33,
-        /* "Ç" */ 2, 195, 135, 5, 30, 161, 225, 33, 18,
-        /* "È" */ 2, 195, 136, 138, 240, 3, 82, 2, 84, 2, 80, 2, 16, 2,
-        /* "É" */ 2, 195, 137, 138, 240, 3, 80, 2, 84, 2, 82, 2, 16, 2,
-        /* "Ê" */ 2, 195, 138, 138, 240, 3, 84, 2, 82, 2, 84, 2, 16, 2,
-        /* "Ë" */ 2, 195, 139, 138, 240, 3, 84, 2, 80, 2, 84, 2, 16, 2,
-        /* "Í" */ 2, 195, 141, 134, 16, 2, 244, 3, 18, 2,
-        /* "Î" */ 2, 195, 142, 134, 20, 2, 242, 3, 20, 2,
-        /* "Ï" */ 2, 195, 143, 134, 20, 2, 240, 3, 20, 2,
-        /* "Ð" */ 2, 195, 144, 6, 8, 63, 41, 33, 34, 28,
-        /* "Ñ" */ 2, 195, 145, 138, 240, 3, 100, 0, 194, 0, 132, 1, 242, 3,
-        /* "Ó" */ 2, 195, 147, 138, 224, 1, 16, 2, 20, 2, 18, 2, 224, 1,
-        /* "Ô" */ 2, 195, 148, 138, 224, 1, 20, 2, 18, 2, 20, 2, 224, 1,
-        /* "Ö" */ 2, 195, 150, 138, 224, 1, 20, 2, 16, 2, 20, 2, 224, 1,
-        /* "Ù" */ 2, 195, 153, 138, 240, 1, 4, 2, 8, 2, 0, 2, 240, 1,
-        /* "Ú" */ 2, 195, 154, 138, 240, 1, 0, 2, 8, 2, 4, 2, 240, 1,
-        /* "Û" */ 2, 195, 155, 138, 240, 1, 4, 2, 2, 2, 4, 2, 240, 1,
-        /* "Ü" */ 2, 195, 156, 138, 240, 1, 4, 2, 0, 2, 4, 2, 240, 1,
-        /* "Ý" */ 2, 195, 157, 138, 48, 0, 64, 0, 136, 3, 68, 0, 48, 0,
-        /* "Þ" */ 2, 195, 158, 4, 63, 18, 18, 12,
-        /* "ß" */ 2, 195, 159, 4, 62, 1, 41, 22,
-        /* "à" */ 2, 195, 160, 138, 0, 1, 164, 2, 168, 2, 160, 2, 192, 3,
-        /* "á" */ 2, 195, 161, 138, 0, 1, 160, 2, 168, 2, 164, 2, 192, 3,
-        /* "â" */ 2, 195, 162, 138, 0, 1, 168, 2, 164, 2, 168, 2, 192, 3,
-        /* "ä" */ 2, 195, 164, 138, 0, 1, 168, 2, 160, 2, 168, 2, 192, 3,
-        /* "æ" */ 2, 195, 166, 9, 16, 42, 42, 42, 60, 42, 42, 42, 12,
-        /* "ç" */ 2, 195, 167, 5, 28, 162, 226, 34, 36,
-        /* "è" */ 2, 195, 168, 138, 192, 1, 164, 2, 168, 2, 160, 2, 192, 0,
-        /* "é" */ 2, 195, 169, 138, 192, 1, 160, 2, 168, 2, 164, 2, 192, 0,
-        /* "ê" */ 2, 195, 170, 138, 192, 1, 168, 2, 164, 2, 168, 2, 192, 0,
-        /* "ë" */ 2, 195, 171, 138, 192, 1, 168, 2, 160, 2, 168, 2, 192, 0,
-        /* "í" */ 2, 195, 173, 132, 80, 0, 200, 3,
-        /* "î" */ 2, 195, 174, 134, 80, 0, 200, 3, 16, 0,
-        /* "ï" */ 2, 195, 175, 3, 5, 60, 1,
-        /* "ð" */ 2, 195, 176, 138, 128, 1, 72, 2, 104, 2, 80, 2, 232, 1,
-        /* "ñ" */ 2, 195, 177, 138, 224, 3, 40, 0, 36, 0, 72, 0, 132, 3,
-        /* "ó" */ 2, 195, 179, 138, 192, 1, 32, 2, 40, 2, 36, 2, 192, 1,
-        /* "ô" */ 2, 195, 180, 138, 192, 1, 40, 2, 36, 2, 40, 2, 192, 1,
-        /* "ö" */ 2, 195, 182, 138, 192, 1, 40, 2, 32, 2, 40, 2, 192, 1,
-        /* "ù" */ 2, 195, 185, 138, 224, 0, 8, 1, 16, 2, 0, 2, 224, 3,
-        /* "ú" */ 2, 195, 186, 138, 224, 0, 0, 1, 16, 2, 8, 2, 224, 3,
-        /* "û" */ 2, 195, 187, 138, 224, 0, 8, 1, 4, 2, 8, 2, 224, 3,
-        /* "ü" */ 2, 195, 188, 138, 224, 0, 8, 1, 0, 2, 8, 2, 224, 3,
-        /* "ý" */ 2, 195, 189, 138, 224, 8, 0, 9, 16, 9, 136, 4, 224, 3,
-        /* "þ" */ 2, 195, 190, 5, 255, 36, 34, 34, 28,
-        /* "Œ" */ 2, 197, 146, 9, 30, 33, 33, 33, 63, 37, 37, 37, 33,
-        /* "œ" */ 2, 197, 147, 9, 28, 34, 34, 34, 28, 42, 42, 42, 12,
-        /* "Ω" */ 2, 206, 169, 5, 46, 49, 1, 49, 46,
-        /* "‘" */ 3, 226, 128, 152, 2, 6, 5,
-        /* "’" */ 3, 226, 128, 153, 2, 5, 3,
-        /* "‚" */ 3, 226, 128, 154, 2, 80, 48,
-        /* "“" */ 3, 226, 128, 156, 5, 6, 5, 0, 6, 5,
-        /* "”" */ 3, 226, 128, 157, 5, 5, 3, 0, 5, 3,
-        /* "„" */ 3, 226, 128, 158, 5, 80, 48, 0, 80, 48,
-        /* "…" */ 3, 226, 128, 166, 5, 32, 0, 32, 0, 32,
-        0
-      };
-      static const short index[] = {
-        -1, -1, 0, -1, -1, -1, 11, -1,
-        60, 78, 106, 124, 148, 178, 210, 235,
-        261, 295, 327, 357, 389, 421, 453, 482,
-        502, 526, 568, 594, 623, 654, 685, 715,
-        -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1,
-        725, 1407, -1, 1433, -1, -1, -1, -1,
-        1442, -1, -1, -1, -1, -1, -1, -1,
-      };
-      int i, l;
+  public:
+    // Lookup the glyph with the longest text which is a prefix of `text`.
+    template<class Char>
+    static const unsigned char *lookup_glyph(const Char *text) {
+      int lo, hi, mid, m = 255, c;
       const unsigned char *glyph;
-      int o;
       if (!text || !*text) return nullptr;
-      o = index[*text >> 2];
-      if (o < 0) {
-        return 0;
-      } else {
-        glyph = glyphs + o;
-      }
-      while ((l = *glyph)) {
-        if (TEXT(glyph)[0] > text[0]) return nullptr;
-        for (i = 0; i < l; ++i) {
-          if (TEXT(glyph)[i] != text[i]) goto next;
+      while (m > 0) {
+        // Find the last glyph whose text sorts before the first m bytes of `text`.
+        lo = 0;
+        hi = GLYPH_COUNT;
+        while (lo < hi) {
+          mid = (lo + hi) / 2;
+          if (compare(GLYPHS + flash_short(INDEX + mid), text, m) <= 0) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
         }
-        return glyph;
-        next:
-        glyph += LENGTH(glyph);
+        if (!lo) return nullptr;
+        glyph = GLYPHS + flash_short(INDEX + lo - 1);
+        for (c = 0; c < TEXT_LENGTH(glyph) && flash_byte(TEXT(glyph) + c) == (unsigned char) text[c]; ++c);
+        if (c == TEXT_LENGTH(glyph)) return glyph;
+        // Only glyphs with texts shorter than the common part can still match.
+        m = c;
       }
       return nullptr;
     }
-};
\ No newline at end of file
+    // The glyph of a digit for fixed width numbers, as placed with TNUM.
+    static const unsigned char *tnum_glyph(int digit) {
+      const unsigned char esc[] = {27, (unsigned char) ('0' + digit), 0};
+      const unsigned char *glyph = lookup_glyph(esc);
+      return glyph ? glyph : lookup_glyph(esc + 1);
+    }
+    // The width of a glyph in columns.
+    static int glyph_width(const unsigned char *glyph) {
+      return GLYPH_COLS(glyph);
+    }
+    // Draw a glyph with its top left corner at x, y - 4.
+    template<class Display>
+    static void draw_glyph(Display &d, const unsigned char *glyph, int x, int y) {
+      int i, cols = GLYPH_COLS(glyph);
+      // Clip the glyph once and draw the visible columns.
+      cols = _min(cols, (int) d.width() - x);
+      for (i = _max(0, -x); i < cols; ++i) {
+        d.blit_column(x + i, y - 4, GLYPH_COL(glyph, i));
+      }
+    }
+  private:
+    // Compare the text of a glyph with the first m bytes of `text`.
+    // Stops at the end of `text`.
+    template<class Char>
+    static int compare(const unsigned char *glyph, const Char *text, int m) {
+      int i, a, l = TEXT_LENGTH(glyph);
+      for (i = 0; i < l && i < m; ++i) {
+        a = flash_byte(TEXT(glyph) + i);
+        if (a != (unsigned char) text[i]) return a - (unsigned char) text[i];
+      }
+      return l - i;
+    }
+    // `lookup_glyph` and `layout` once more as C++11 constexpr functions for `prerender`.
+    // They read the font directly.
+    template<class Char>
+    static constexpr int constant_compare(const unsigned char *glyph, const Char *text, int m, int i = 0) {
+      return i < TEXT_LENGTH<false>(glyph) && i < m ?
+        (READ<false>(TEXT(glyph) + i) != (unsigned char) text[i] ?
+          READ<false>(TEXT(glyph) + i) - (unsigned char) text[i] : constant_compare(glyph, text, m, i + 1)) :
+        TEXT_LENGTH<false>(glyph) - i;
+    }
+    // The number of bytes the text of a glyph has in common with `text`.
+    template<class Char>
+    static constexpr int constant_common(const unsigned char *glyph, const Char *text, int c = 0) {
+      return c < TEXT_LENGTH<false>(glyph) && READ<false>(TEXT(glyph) + c) == (unsigned char) text[c] ?
+        constant_common(glyph, text, c + 1) : c;
+    }
+    // The end of the glyphs between lo and hi in the index whose text sorts before the
+    // first m bytes of `text`.
+    template<class Char>
+    static constexpr int constant_upper(const Char *text, int m, int lo, int hi) {
+      return lo < hi ?
+        (constant_compare(GLYPHS + INDEX[(lo + hi) / 2], text, m) <= 0 ?
+          constant_upper(text, m, (lo + hi) / 2 + 1, hi) : constant_upper(text, m, lo, (lo + hi) / 2)) :
+        lo;
+    }
+    template<class Char>
+    static constexpr const unsigned char *constant_glyph(const Char *text, int m = 255) {
+      return *text && m > 0 ? constant_found(text, constant_upper(text, m, 0, GLYPH_COUNT)) : nullptr;
+    }
+    template<class Char>
+    static constexpr const unsigned char *constant_found(const Char *text, int lo) {
+      return lo ? constant_longest(text, GLYPHS + INDEX[lo - 1],
+                                   constant_common(GLYPHS + INDEX[lo - 1], text)) : nullptr;
+    }
+    // Only glyphs with texts shorter than the common part can still match.
+    template<class Char>
+    static constexpr const unsigned char *constant_longest(const Char *text, const unsigned char *glyph, int c) {
+      return c == TEXT_LENGTH<false>(glyph) ? glyph : constant_glyph(text, c);
+    }
+    // Where `constant_layout` is after a part of the text.
+    struct Pen {
+      const char *text;
+      int n;
+      unsigned t;
+      bool was_num;
+    };
+    static constexpr bool constant_digit(const char *text) {
+      return '0' <= *text && *text <= '9';
+    }
+    // The glyph placed for `glyph` at `text`, which is the fixed width digit with TNUM.
+    static constexpr const unsigned char *constant_shape(const char *text, int options, const unsigned char *glyph) {
+      return (options & TNUM) && constant_digit(text) && constant_glyph(constant_escape(*text)) ?
+        constant_glyph(constant_escape(*text)) : glyph;
+    }
+    // The texts "\e0" to "\e9" of the fixed width digits.
+    static constexpr const char *constant_escape(char digit) {
+      return "\0330\0\0331\0\0332\0\0333\0\0334\0\0335\0\0336\0\0337\0\0338\0\0339" + 3 * (digit - '0');
+    }
+    // The column where a glyph is placed at the pen, with kerning.
+    static constexpr int constant_x(Pen p, int options, const unsigned char *glyph, bool num) {
+      return p.n + (p.n && (((options & TNUM) && (num || p.was_num)) ||
+                            ((GLYPH_COL<false>(glyph, 0) | GLYPH_COL<false>(glyph, 0) << 1) & (p.t | p.t << 1))) ? 1 : 0) +
+        ((options & TNUM) && num ? (TNUM_WIDTH - GLYPH_COLS<false>(glyph)) / 2 : 0);
+    }
+    // The pen after placing a glyph at column x for `length` bytes of text.
+    static constexpr Pen constant_after(Pen p, int options, int length, const unsigned char *glyph, bool num, int x) {
+      return Pen{p.text + length,
+                 x + GLYPH_COLS<false>(glyph) + ((options & TNUM) && num ? (TNUM_WIDTH + 1 - GLYPH_COLS<false>(glyph)) / 2 : 0),
+                 GLYPH_COL<false>(glyph, GLYPH_COLS<false>(glyph) - 1), num};
+    }
+    static constexpr Pen constant_place(Pen p, int options, int length, const unsigned char *glyph) {
+      return constant_after(p, options, length, glyph, constant_digit(p.text),
+                            constant_x(p, options, glyph, constant_digit(p.text)));
+    }
+    static constexpr Pen constant_step_glyph(Pen p, int options, const unsigned char *glyph) {
+      return glyph ? constant_place(p, options, TEXT_LENGTH<false>(glyph), constant_shape(p.text, options, glyph)) :
+        Pen{p.text + 1, p.n, p.t, p.was_num};
+    }
+    // The pen after the next space, glyph or unknown byte of the text.
+    static constexpr Pen constant_step(Pen p, int options) {
+      return *p.text == ' ' ? Pen{p.text + 1, p.n + SPACE_WIDTH, 0, p.was_num} :
+        *p.text == '\b' ? Pen{p.text + 1, p.n, 0, p.was_num} :
+        constant_step_glyph(p, options, constant_glyph(p.text));
+    }
+    static constexpr int constant_width(Pen p, int options) {
+      return *p.text ? constant_width(constant_step(p, options), options) : p.n;
+    }
+    // Column i of the glyph placed at column x.
+    static constexpr unsigned constant_cover(const unsigned char *glyph, int x, int i) {
+      return x <= i && i < x + GLYPH_COLS<false>(glyph) ? GLYPH_COL<false>(glyph, i - x) : 0;
+    }
+    static constexpr unsigned constant_shaped(Pen p, int options, const unsigned char *glyph, int i) {
+      return constant_cover(glyph, constant_x(p, options, glyph, constant_digit(p.text)), i);
+    }
+    static constexpr unsigned constant_column_at(Pen p, int options, const unsigned char *glyph, int i) {
+      return *p.text != ' ' && *p.text != '\b' && glyph ?
+        constant_shaped(p, options, constant_shape(p.text, options, glyph), i) : 0;
+    }
+    // Column i of the text laid out from the pen on.
+    static constexpr unsigned constant_column(Pen p, int options, int i) {
+      return *p.text ?
+        constant_column_at(p, options, constant_glyph(p.text), i) | constant_column(constant_step(p, options), options, i) :
+        0;
+    }
+    template<int... I>
+    struct Columns {};
+    // Columns<0, 1, ..., N - 1>
+    template<int N, int... I>
+    struct Sequence : Sequence<N - 1, N - 1, I...> {};
+    template<int... I>
+    struct Sequence<0, I...> {
+      typedef Columns<I...> type;
+    };
+    template<int N, int... I>
+    static constexpr Bitmap<N> constant_bitmap(const char *text, int options, Columns<I...>) {
+      return Bitmap<N>{{(short) constant_column(Pen{text, 0, 0, false}, options, I)...}, options};
+    }
+    static constexpr const unsigned char *GLYPHS = AWAKENING_GLYPHS;
+    static constexpr const short *INDEX = AWAKENING_INDEX;
+    static constexpr int GLYPH_COUNT = sizeof(AWAKENING_INDEX) / sizeof(*AWAKENING_INDEX);
+};
+
+// Declare `name` as a line of text which is rendered at compile time and kept in program
+// memory, e.g.
+//
+//   static AWAKENING_PRERENDER(LABEL, "Hallo", Awakening::CENTER);
+//   LABEL.draw(display, 0, 10, 128);
+#define AWAKENING_PRERENDER(name, text, options) \
+  constexpr Awakening::Bitmap<Awakening::prerender_width(text, options)> name FLASH = \
+    Awakening::prerender<Awakening::prerender_width(text, options)>(text, options)
@@ -0,0 +1,39 @@
+#pragma once
+
+// Timing for the benchmarks.
+//
+// The clock of host/ only advances with register accesses, delays and bus time, so it
+// measures transfers but not computations. Drawing is timed on the host instead, which
+// compares implementations but is no measure of the time on the board.
+
+#include <chrono>
+#include <stdio.h>
+
+// The host nanoseconds per call of `f`, run for at least 0.1 s.
+template<class F>
+double host_ns(F f) {
+  typedef std::chrono::steady_clock clock;
+  std::chrono::duration<double, std::nano> elapsed;
+  unsigned long n = 0, batch = 1;
+  clock::time_point start = clock::now();
+  do {
+    for (unsigned long i = 0; i < batch; ++i) f();
+    n += batch;
+    batch *= 2;
+    elapsed = clock::now() - start;
+  } while (elapsed.count() < 1e8);
+  return elapsed.count() / n;
+}
+
+// Print one row of host timings.
+inline void report_ns(const char *name, double ns) {
+  printf("%-36s %10.0f ns\n", name, ns);
+}
+
+// Print one row of bus figures: the CPU cycles, the bytes sent and the time the bus was
+// busy, in cycles at F_CPU.
+inline void report_bus(const char *name, unsigned long long cycles, unsigned long bytes,
+                       unsigned long long bus_cycles) {
+  printf("%-36s %10llu cycles %6lu bytes %8.2f ms bus\n", name, cycles, bytes,
+         bus_cycles * 1000.0 / F_CPU);
+}
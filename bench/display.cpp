@@ -0,0 +1,26 @@
+// The drawing primitives of `Display` on a 128x64 frame buffer.
+
+#include <Arduino.h>
+#include "display.h"
+#include "bench.h"
+
+static Display<128, 64> d;
+
+int main() {
+  int i = 0;
+  printf("Display<128, 64> on the host\n");
+  report_ns("clear", host_ns([&] { d.clear(); }));
+  report_ns("pixel", host_ns([&] { d.pixel(i++ & 127, 20); }));
+  report_ns("hline 128", host_ns([&] { d.hline(0, 127, 20); }));
+  report_ns("vline 64", host_ns([&] { d.vline(20, 0, 63); }));
+  report_ns("line 128x64", host_ns([&] { d.line(0, 0, 127, 63); }));
+  report_ns("fill_rect 64x32", host_ns([&] { d.fill_rect(10, 13, 73, 44, 1); }));
+  report_ns("invert 128x64", host_ns([&] { d.invert(0, 0, 128, 64); }));
+  report_ns("rect 64x32", host_ns([&] { d.rect(10, 13, 73, 44); }));
+  report_ns("round_rect 64x32 r 6", host_ns([&] { d.round_rect(10, 13, 73, 44, 6); }));
+  report_ns("fill_round_rect 64x32 r 6", host_ns([&] { d.fill_round_rect(10, 13, 73, 44, 6); }));
+  report_ns("circle r 30", host_ns([&] { d.circle(64, 32, 30); }));
+  report_ns("fill_circle r 30", host_ns([&] { d.fill_circle(64, 32, 30); }));
+  report_ns("blit_column 16 rows", host_ns([&] { d.blit_column(i++ & 127, 21, 0xa5a5); }));
+  return 0;
+}
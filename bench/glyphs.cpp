@@ -0,0 +1,54 @@
+// Text drawn with `blit_column` against plotting every pixel of a glyph column, as the
+// renderer did before.
+
+#include <Arduino.h>
+#include "display.h"
+#include "awakening.h"
+#include "bench.h"
+
+// A display which draws glyph columns the old way, with a call of `pixel` for every
+// set bit.
+template<class D>
+struct PerPixel {
+  D &d;
+  unsigned width() const {
+    return d.width();
+  }
+  void blit_column(int x, int y, unsigned bits, int = D::OR, int height = 16) {
+    unsigned bit = 1;
+    if (x < 0 || x >= (int) d.width()) return;
+    for (int r = y; r <= y + height; ++r) {
+      if (bits & bit) d.pixel(x, r);
+      bit <<= 1;
+    }
+  }
+};
+
+static Display<128, 64> d;
+static const char *const LINES[] = {
+  "Hier könnte Ihre", "Werbung stehen!", "Comment ça va?", "120kΩ 1769"
+};
+
+template<class D>
+static void draw(D &d) {
+  for (int i = 0; i < 4; ++i) Awakening::text_centered(d, LINES[i], 0, 2 + 12 * i, 128);
+}
+
+int main() {
+  static PerPixel<decltype(d)> per_pixel{d};
+  unsigned char expected[1024];
+  double old_ns, new_ns;
+  d.clear();
+  draw(per_pixel);
+  memcpy(expected, d.data(), sizeof(expected));
+  d.clear();
+  draw(d);
+  printf("Four centered lines on the host, %s picture\n",
+         memcmp(expected, d.data(), sizeof(expected)) ? "DIFFERENT" : "same");
+  old_ns = host_ns([&] { draw(per_pixel); });
+  new_ns = host_ns([&] { draw(d); });
+  report_ns("pixel per bit", old_ns);
+  report_ns("blit_column", new_ns);
+  printf("%-36s %10.1f x\n", "speedup", old_ns / new_ns);
+  return 0;
+}
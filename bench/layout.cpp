@@ -0,0 +1,44 @@
+// The cost of laying out each line of the sketch, and of drawing it centered by
+// measuring and drawing in two passes, in one pass, and from a cached `Run`.
+
+#include <Arduino.h>
+#include "display.h"
+#include "awakening.h"
+#include "bench.h"
+
+static Display<128, 64> d;
+static const char *const LINES[] = {
+  "Hier könnte Ihre", "Werbung stehen!", "Comment ça va?", "120kΩ 1769"
+};
+
+// Print `text` padded to `w` characters, counting UTF-8 sequences as one.
+static void pad(const char *text, int w) {
+  for (const char *p = text; *p; ++p) w -= (*p & 0xc0) != 0x80;
+  printf("%s%*s", text, w > 0 ? w : 0, "");
+}
+
+int main() {
+  static Awakening::Run<> run;
+  const char *text;
+  printf("%-20s %10s %10s %10s %10s   ns on the host\n",
+         "", "layout", "two passes", "one pass", "cached");
+  for (int i = 0; i < 4; ++i) {
+    text = LINES[i];
+    double layout = host_ns([&] {
+      run.invalidate();
+      run.layout(text, 128, Awakening::CENTER);
+    });
+    double two = host_ns([&] {
+      int n = Awakening::text_with_options(d, text, 0, 2, 128, Awakening::TEXT_WIDTH);
+      Awakening::text(d, text, (128 - n) / 2, 2, 128);
+    });
+    double one = host_ns([&] { Awakening::text_centered(d, text, 0, 2, 128); });
+    double cached = host_ns([&] {
+      run.layout(text, 128, Awakening::CENTER);
+      run.draw(d, 0, 2, 128);
+    });
+    pad(text, 20);
+    printf(" %10.0f %10.0f %10.0f %10.0f\n", layout, two, one, cached);
+  }
+  return 0;
+}
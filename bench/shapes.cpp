@@ -0,0 +1,41 @@
+// The primitives and shapes of `Display` against drawing them pixel by pixel.
+
+#include <Arduino.h>
+#include "display.h"
+#include "../test/reference.h"
+#include "bench.h"
+
+static Display<128, 64> d;
+static Reference<128, 64> r;
+
+template<class D>
+static void draw(D &d, int op) {
+  switch (op) {
+  case 0: d.fill_rect(0, 0, 128, 64, 1); break;
+  case 1: d.fill_rect(10, 13, 73, 44, 1); break;
+  case 2: d.invert(10, 13, 73, 44); break;
+  case 3: d.line(0, 20, 127, 20); break;
+  case 4: d.line(20, 0, 20, 63); break;
+  case 5: d.rect(10, 13, 73, 44); break;
+  case 6: d.round_rect(10, 13, 73, 44, 6); break;
+  case 7: d.fill_round_rect(10, 13, 73, 44, 6); break;
+  case 8: d.circle(64, 32, 30); break;
+  default: d.fill_circle(64, 32, 30); break;
+  }
+}
+
+int main() {
+  static const char *const NAMES[] = {
+    "fill_rect 128x64", "fill_rect 64x32", "invert 64x32", "horizontal line 128",
+    "vertical line 64", "rect 64x32", "round_rect 64x32 r 6", "fill_round_rect 64x32 r 6",
+    "circle r 30", "fill_circle r 30"
+  };
+  double fast, plain;
+  printf("%-28s %10s %10s   ns on the host\n", "", "Display", "pixels");
+  for (int op = 0; op < 10; ++op) {
+    fast = host_ns([&] { draw(d, op); });
+    plain = host_ns([&] { draw(r, op); });
+    printf("%-28s %10.0f %10.0f %8.1f x\n", NAMES[op], fast, plain, plain / fast);
+  }
+  return 0;
+}
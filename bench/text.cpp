@@ -0,0 +1,31 @@
+// Text in the Awakening font, measured, drawn and prerendered.
+
+#include <Arduino.h>
+#include "display.h"
+#include "awakening.h"
+#include "paragraph.h"
+#include "bench.h"
+
+static Display<128, 64> d;
+static AWAKENING_PRERENDER(LINE, "Hier könnte Ihre", Awakening::CENTER);
+static const char LINE_TEXT[] = "Hier könnte Ihre";
+static const char *const TEXT = "Hier könnte Ihre Werbung stehen! Comment ça va?";
+
+int main() {
+  static Paragraph<> paragraph;
+  printf("Awakening on the host\n");
+  report_ns("width \"Hier könnte Ihre\"",
+            host_ns([&] { Awakening::width(LINE_TEXT, LINE_TEXT + strlen(LINE_TEXT)); }));
+  report_ns("text_centered \"Hier könnte Ihre\"",
+            host_ns([&] { Awakening::text_centered(d, "Hier könnte Ihre", 0, 2, 128); }));
+  report_ns("prerendered \"Hier könnte Ihre\"", host_ns([&] { LINE.draw(d, 0, 2, 128); }));
+  report_ns("text TNUM \"120kΩ 1769\"", host_ns([&] {
+    Awakening::text_with_options(d, "120kΩ 1769", 0, 40, 128, Awakening::RIGHT | Awakening::TNUM);
+  }));
+  report_ns("Paragraph layout 47 characters", host_ns([&] {
+    paragraph.invalidate();
+    paragraph.layout(TEXT, 128, Awakening::CENTER);
+  }));
+  report_ns("Paragraph draw 4 lines", host_ns([&] { paragraph.draw(d, 0, 0, 48); }));
+  return 0;
+}
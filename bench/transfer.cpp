@@ -0,0 +1,65 @@
+// Frames sent to a simulated SSD1306, by software I2C on I2cBus and by the TWI.
+// Reports the CPU cycles of the transfer, the bytes on the bus and the bus time.
+
+#include <Arduino.h>
+#include "software-i2c.h"
+#include "hardware-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "bench.h"
+
+static SoftwareI2c<20, 21> software;
+static HardwareI2c<> hardware;
+static Display<128, 64> d;
+
+static void draw(int n) {
+  char digits[8];
+  d.clear();
+  Awakening::text_centered(d, "Hier könnte Ihre", 0, 2, 128);
+  Awakening::text_centered(d, "Werbung stehen!", 0, 14, 128);
+  snprintf(digits, sizeof(digits), "%d", n);
+  Awakening::text_with_options(d, digits, 0, 40, 128, Awakening::CENTER | Awakening::TNUM);
+}
+
+int main() {
+  static I2cBus bus(20, 21);
+  static Ssd1306Model software_model, hardware_model;
+  static Ssd1306<I2cTransport<decltype(software)>> full{software};
+  static Ssd1306<I2cTransport<decltype(software)>, true> shadow{software};
+  static Ssd1306<I2cTransport<decltype(hardware)>> twi{hardware};
+  unsigned long long cycles, bus_cycles;
+  unsigned long bytes;
+  bus.attach(&software_model);
+  host_twi.device = &hardware_model;
+  full.init();
+  twi.init();
+  draw(1769);
+
+  printf("128x64 frame at %lu MHz\n", F_CPU / 1000000);
+  cycles = host_gpio.cycles;
+  bytes = bus.bytes;
+  bus_cycles = bus.bus_cycles;
+  full.display(d.data());
+  report_bus("software i2c, full frame", host_gpio.cycles - cycles, bus.bytes - bytes,
+             bus.bus_cycles - bus_cycles);
+
+  shadow.display(d.data());
+  draw(1770);
+  cycles = host_gpio.cycles;
+  bytes = bus.bytes;
+  bus_cycles = bus.bus_cycles;
+  shadow.display(d.data());
+  report_bus("software i2c, shadow, one number", host_gpio.cycles - cycles, bus.bytes - bytes,
+             bus.bus_cycles - bus_cycles);
+
+  cycles = host_twi.cycles;
+  bytes = host_twi.bytes;
+  twi.display(d.data());
+  // The TWI sends on its own, but `display` waits for it.
+  report_bus("twi, full frame", host_twi.cycles - cycles, host_twi.bytes - bytes,
+             host_twi.cycles - cycles);
+  return 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "awakening.h"
+
+// A list of up to N drawing operations which can be replayed on any display.
+//
+// Together with a `Strip` this draws a whole frame with only one page of RAM:
+// record the frame once and let `Strip::render` replay it for every page.
+// Texts are not copied, they have to stay valid until the list is replayed.
+template<unsigned N = 16>
+class DisplayList {
+    static constexpr unsigned char TEXT = 0;
+    static constexpr unsigned char LINE = 1;
+    static constexpr unsigned char FILL_RECT = 2;
+    static constexpr unsigned char INVERT = 3;
+    struct Op {
+      unsigned char type;
+      short a, b, c, d, e;
+      const char *text;
+    };
+    Op ops[N];
+    unsigned count = 0;
+    bool add(unsigned char type, int a, int b, int c, int d, int e = 0, const char *text = nullptr) {
+      if (count == N) return false;
+      ops[count++] = {type, (short) a, (short) b, (short) c, (short) d, (short) e, text};
+      return true;
+    }
+  public:
+    // Remove all operations.
+    void clear() {
+      count = 0;
+    }
+    // The operations return false if the list is full.
+    bool text(const char *text, int x, int y, int w, int options = Awakening::LEFT) {
+      return add(TEXT, x, y, w, options, 0, text);
+    }
+    bool line(int x1, int y1, int x2, int y2) {
+      return add(LINE, x1, y1, x2, y2);
+    }
+    bool fill_rect(int x1, int y1, int x2, int y2, int v) {
+      return add(FILL_RECT, x1, y1, x2, y2, v);
+    }
+    bool invert(int x1, int y1, int x2, int y2) {
+      return add(INVERT, x1, y1, x2, y2);
+    }
+    // Draw all operations in order. Texts which do not reach into the rows y1 to y2
+    // (exclusive) are skipped.
+    template<class Display>
+    void replay(Display &d, int y1 = 0, int y2 = 0x7fff) const {
+      for (unsigned i = 0; i < count; ++i) {
+        const Op &op = ops[i];
+        switch (op.type) {
+        case TEXT:
+          if (op.b + 12 > y1 && op.b - 4 < y2) {
+            Awakening::text_with_options(d, op.text, op.a, op.b, op.c, op.d);
+          }
+          break;
+        case LINE:
+          d.line(op.a, op.b, op.c, op.d);
+          break;
+        case FILL_RECT:
+          d.fill_rect(op.a, op.b, op.c, op.d, op.e);
+          break;
+        case INVERT:
+          d.invert(op.a, op.b, op.c, op.d);
+          break;
+        }
+      }
+    }
+};
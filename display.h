@@ -1,82 +1,136 @@
 #pragma once
 
-template<unsigned WIDTH, unsigned HEIGHT>
-class Display {
-    unsigned char buffer[WIDTH * HEIGHT / 8];
+#include <string.h>
+#include "shapes.h"
+#include "orientation.h"
+
+// With BUFFERS = 2 the display is double buffered. Drawing goes to the back buffer
+// while the front buffer can be sent, and `swap` exchanges them.
+//
+// With `orientation` ROTATE_90 or ROTATE_270 the pixels are stored transposed, so the
+// frame buffer has the layout of a HEIGHT x WIDTH panel. Other orientations are left to
+// the controller and do not change the frame buffer.
+template<unsigned WIDTH, unsigned HEIGHT, unsigned BUFFERS = 1, int orientation = ROTATE_0>
+class Display : public Shapes<Display<WIDTH, HEIGHT, BUFFERS, orientation>> {
+    static_assert(BUFFERS == 1 || BUFFERS == 2, "Only single and double buffering are supported");
+    static constexpr bool TRANSPOSED = orientation & 1;
+    static_assert((TRANSPOSED ? WIDTH : HEIGHT) % 8 == 0, "The panel height has to be a multiple of 8");
+    // The size of the frame buffer.
+    static constexpr int COLUMNS = TRANSPOSED ? HEIGHT : WIDTH;
+    static constexpr int ROWS = TRANSPOSED ? WIDTH : HEIGHT;
+    unsigned char buffers[BUFFERS][WIDTH * HEIGHT / 8];
+    unsigned char *buffer = buffers[0];
+    unsigned char *shown = buffers[BUFFERS - 1];
   public:
+    using Shapes<Display>::OR;
+    using Shapes<Display>::AND;
+    using Shapes<Display>::XOR;
     unsigned width() const {
       return WIDTH;
     }
     unsigned height() const {
       return HEIGHT;
     }
+    // The buffer which is drawn to.
     const unsigned char *data() const {
       return buffer;
     }
+    // The buffer which is sent to the panel. Same as `data` unless double buffered.
+    const unsigned char *front() const {
+      return shown;
+    }
+    // Make the back buffer the front buffer and the other way around.
+    void swap() {
+      unsigned char *t = buffer;
+      buffer = shown;
+      shown = t;
+    }
     // Invert everything in the area between x1, y1 and x2, y2.
     void invert(int x1, int y1, int x2, int y2) {
-      int t, r, c;
-      unsigned char m;
-      if (x2 < x1) {
-        t = x2; x2 = x1; x1 = t;
-      }
-      if (y2 < y1) {
-        t = y2; y2 = y1; y1 = t;
-      }
-      x1 = _min(_max(x1, 0), WIDTH);
-      y1 = _min(_max(y1, 0), HEIGHT);
-      x2 = _min(_max(x2, 0), WIDTH);
-      y2 = _min(_max(y2, 0), HEIGHT);
-      for (r = y1 >> 3; r <= y2 >> 3; ++r) {
-        m = 0xff;
-        if (r == y1 >> 3) m &= 0xff << (y1 & 7);
-        if (r == y2 >> 3) m &= 0xff >> (8 - y2 & 7);
-        if (!m) return 0;
-        for (c = x1; c < x2; ++c) {
-          buffer[r * WIDTH + c] ^= m;
-        }
-      }
+      area(x1, y1, x2, y2, INVERT);
     }
     // Paint everything in the area between x1, y1 and x2, y2.
     // Paint black if v == 0, white otherwise.
     void fill_rect(int x1, int y1, int x2, int y2, int v) {
-      int t, r, c;
-      unsigned char m;
+      area(x1, y1, x2, y2, v ? SET : CLEAR);
+    }
+    // Draw a horizontal line from x1 to x2 (inclusive) in row y.
+    void hline(int x1, int x2, int y, bool v = true) {
       if (x2 < x1) {
-        t = x2; x2 = x1; x1 = t;
+        int t = x2; x2 = x1; x1 = t;
       }
+      area(x1, y, x2 + 1, y + 1, v ? SET : CLEAR);
+    }
+    // Draw a vertical line from y1 to y2 (inclusive) in column x.
+    void vline(int x, int y1, int y2, bool v = true) {
       if (y2 < y1) {
-        t = y2; y2 = y1; y1 = t;
-      }
-      x1 = _min(_max(x1, 0), WIDTH);
-      y1 = _min(_max(y1, 0), HEIGHT);
-      x2 = _min(_max(x2, 0), WIDTH);
-      y2 = _min(_max(y2, 0), HEIGHT);
-      for (r = y1 >> 3; r <= y2 >> 3; ++r) {
-        m = 0xff;
-        if (r == y1 >> 3) m &= 0xff << (y1 & 7);
-        if (r == y2 >> 3) m &= 0xff >> (8 - y2 & 7);
-        if (!m) return 0;
-        for (c = x1; c < x2; ++c) {
-          if (v) {
-            buffer[r * WIDTH + c] |= m;
-          } else {
-            buffer[r * WIDTH + c] &= ~m;
-          }
-        }
+        int t = y2; y2 = y1; y1 = t;
       }
+      area(x, y1, x + 1, y2 + 1, v ? SET : CLEAR);
     }
     // Set the pixel at position x, y to value v (0 or 1).
     void pixel(int x, int y, bool v = true) {
-      if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+      if (x < 0 || x >= (int) WIDTH || y < 0 || y >= (int) HEIGHT) return;
+      if constexpr (TRANSPOSED) {
+        int t = x; x = y; y = t;
+      }
       if (v) {
-        buffer[x + (y >> 3) * WIDTH] |= 1 << (y & 7);
+        buffer[x + (y >> 3) * COLUMNS] |= 1 << (y & 7);
       } else {
-        buffer[x + (y >> 3) * WIDTH] &= ~(1 << (y & 7));
+        buffer[x + (y >> 3) * COLUMNS] &= ~(1 << (y & 7));
+      }
+    }
+    // Paint the pixels set in a column of up to 16 pixels white.
+    // Bit 0 of `bits` is the pixel at x, y and the column extends downwards.
+    // With `mode` AND or XOR the `height` topmost pixels of the column are combined with
+    // the display that way instead.
+    void blit_column(int x, int y, unsigned bits, int mode = OR, int height = 16) {
+      unsigned long v, m;
+      unsigned char *p;
+      if (x < 0 || x >= (int) WIDTH || y >= (int) HEIGHT || y <= -height) return;
+      if constexpr (TRANSPOSED) {
+        // The column is a row of the frame buffer.
+        m = 1 << (x & 7);
+        p = buffer + (x >> 3) * COLUMNS;
+        for (int i = _max(0, -y); i < height && y + i < (int) HEIGHT; ++i) {
+          if (mode == AND ? !(bits >> i & 1) : bits >> i & 1) {
+            if (mode == OR) {
+              p[y + i] |= m;
+            } else if (mode == XOR) {
+              p[y + i] ^= m;
+            } else {
+              p[y + i] &= ~m;
+            }
+          }
+        }
+        return;
+      }
+      m = (1UL << height) - 1;
+      if (y < 0) {
+        bits >>= -y;
+        m >>= -y;
+        y = 0;
+      }
+      v = (unsigned long) bits << (y & 7);
+      m <<= y & 7;
+      p = buffer + (y >> 3) * WIDTH + x;
+      for (int r = y >> 3; (v || (mode == AND && m)) && r < (int) HEIGHT / 8; ++r) {
+        if (mode == OR) {
+          *p |= v;
+        } else if (mode == XOR) {
+          *p ^= v;
+        } else {
+          *p &= v | ~m;
+        }
+        p += WIDTH;
+        v >>= 8;
+        m >>= 8;
       }
     }
     // Draw a straight line from x1, y1 to x2, y2.
     void line(int x1, int y1, int x2, int y2) {
+      if (y1 == y2) return hline(x1, x2, y1);
+      if (x1 == x2) return vline(x1, y1, y2);
       int dx = _abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
       int dy = _abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
       int err = (dx > dy ? dx : -dy) / 2, e2;
@@ -90,9 +144,48 @@ class Display {
     }
     // Makes all pixels black if v == 0, white otherwise.
     void clear(bool v = false) {
-      memset(buffer, v ? 0xff : 0x00, sizeof(buffer));
+      memset(buffer, v ? 0xff : 0x00, sizeof(buffers[0]));
     }
   private:
+    static constexpr int CLEAR = 0;
+    static constexpr int SET = 1;
+    static constexpr int INVERT = 2;
+    // Clear, set or invert the area between x1, y1 and x2, y2 page by page.
+    // Rows which cover a whole byte are written with memset.
+    void area(int x1, int y1, int x2, int y2, int op) {
+      int t, r, c;
+      unsigned char m, *p;
+      if constexpr (TRANSPOSED) {
+        t = x1; x1 = y1; y1 = t;
+        t = x2; x2 = y2; y2 = t;
+      }
+      if (x2 < x1) {
+        t = x2; x2 = x1; x1 = t;
+      }
+      if (y2 < y1) {
+        t = y2; y2 = y1; y1 = t;
+      }
+      x1 = _min(_max(x1, 0), COLUMNS);
+      y1 = _min(_max(y1, 0), ROWS);
+      x2 = _min(_max(x2, 0), COLUMNS);
+      y2 = _min(_max(y2, 0), ROWS);
+      if (x1 == x2 || y1 == y2) return;
+      for (r = y1 >> 3; r <= (y2 - 1) >> 3; ++r) {
+        m = 0xff;
+        if (r == y1 >> 3) m &= 0xff << (y1 & 7);
+        if (r == (y2 - 1) >> 3) m &= 0xff >> (7 - ((y2 - 1) & 7));
+        p = buffer + r * COLUMNS;
+        if (op == INVERT) {
+          for (c = x1; c < x2; ++c) p[c] ^= m;
+        } else if (m == 0xff) {
+          memset(p + x1, op == SET ? 0xff : 0x00, x2 - x1);
+        } else if (op == SET) {
+          for (c = x1; c < x2; ++c) p[c] |= m;
+        } else {
+          for (c = x1; c < x2; ++c) p[c] &= ~m;
+        }
+      }
+    }
     int _max(int a, int b) {
       return a < b ? b : a;
     }
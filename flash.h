@@ -0,0 +1,33 @@
+#pragma once
+
+// Constant data in program memory.
+//
+// On AVR constant arrays are copied to RAM at startup unless they are declared with
+// FLASH, and then they can only be read through the functions below. Everywhere else
+// FLASH does nothing and the functions are plain reads.
+
+#if defined(__AVR__)
+
+#include <avr/pgmspace.h>
+
+#define FLASH PROGMEM
+
+inline unsigned char flash_byte(const unsigned char *p) {
+  return pgm_read_byte(p);
+}
+inline short flash_short(const short *p) {
+  return pgm_read_word(p);
+}
+
+#else
+
+#define FLASH
+
+inline unsigned char flash_byte(const unsigned char *p) {
+  return *p;
+}
+inline short flash_short(const short *p) {
+  return *p;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+// Sends frames to an `Ssd1306` in chunks of CHUNK bytes, so that drawing the next
+// frame can go on meanwhile.
+//
+// `poll` sends one chunk. Call it from `loop` or from a timer interrupt, e.g.
+//
+//   ISR(TIMER2_COMPA_vect) {
+//     transfer.poll();
+//   }
+//
+// A chunk blocks for its whole bus time, so keep CHUNK small when polling from an
+// interrupt. CHUNK has to divide the width of the panel.
+//
+// With a double buffered `Display`, `present` swaps the buffers and starts sending
+// the new front buffer once the previous one is done, so no frame is ever torn.
+template<class Ssd, unsigned CHUNK = 32>
+class FrameTransfer {
+    static_assert(Ssd::WIDTH % CHUNK == 0, "CHUNK has to divide the panel width");
+    static constexpr unsigned SIZE = Ssd::WIDTH * Ssd::PAGES;
+    Ssd &ssd;
+    // All of them are volatile, so an interrupt calling `poll` sees the new frame once it
+    // sees `active`.
+    const unsigned char *volatile frame;
+    volatile unsigned position;
+    volatile bool resync;
+    volatile bool active = false;
+  public:
+    FrameTransfer(Ssd &ssd) : ssd(ssd) {}
+    bool busy() const {
+      return active;
+    }
+    // Begin sending a frame. It must not change until `busy` returns false.
+    bool start(const unsigned char *buffer) {
+      if (active) return false;
+      frame = buffer;
+      position = 0;
+      resync = true;
+      active = true;
+      return true;
+    }
+    // Swap the buffers of `d` and begin sending the new front buffer.
+    // Returns false without swapping while the previous frame is still being sent.
+    template<class Display>
+    bool present(Display &d) {
+      if (active) return false;
+      d.swap();
+      return start(d.front());
+    }
+    // Send the next chunk of the current frame, if any.
+    void poll() {
+      if (!active) return;
+      int page = position / Ssd::WIDTH, c = position % Ssd::WIDTH;
+      if constexpr (Ssd::SHADOW) {
+        ssd.update(frame, page, c, c + CHUNK);
+      } else if (resync) {
+        // Open the window up to the end of the frame, so the next chunks can follow
+        // without moving it again.
+        if (c == 0) {
+          resync = !ssd.window(0, Ssd::WIDTH - 1, page, Ssd::PAGES - 1) ||
+            !ssd.write(frame + position, CHUNK);
+        } else {
+          ssd.update(frame, page, c, c + CHUNK);
+        }
+      } else {
+        resync = !ssd.write(frame + position, CHUNK);
+      }
+      position += CHUNK;
+      if (position >= SIZE) active = false;
+    }
+};
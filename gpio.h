@@ -0,0 +1,157 @@
+#pragma once
+
+// Pins are types with static `high`, `low` and `read` functions, so all the
+// register addresses and masks are known at compile time.
+//
+// `high` releases the line and enables the pull-up, `low` pulls it down. This is
+// the open-drain behavior needed for I2C. For push-pull lines call `output` once and
+// then `set`.
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#endif
+
+#if defined(__AVR__)
+
+#include <avr/io.h>
+#include <util/delay_basic.h>
+
+// Declare a port type with accessors for its three registers.
+#define GPIO_PORT(name) \
+  template<> struct GpioPort<#name[0]> { \
+    static volatile unsigned char &ddr() { return DDR##name; } \
+    static volatile unsigned char &port() { return PORT##name; } \
+    static volatile unsigned char &pin() { return PIN##name; } \
+  };
+
+template<char NAME>
+struct GpioPort;
+
+#ifdef PORTA
+GPIO_PORT(A)
+#endif
+#ifdef PORTB
+GPIO_PORT(B)
+#endif
+#ifdef PORTC
+GPIO_PORT(C)
+#endif
+#ifdef PORTD
+GPIO_PORT(D)
+#endif
+#ifdef PORTE
+GPIO_PORT(E)
+#endif
+#ifdef PORTF
+GPIO_PORT(F)
+#endif
+#ifdef PORTG
+GPIO_PORT(G)
+#endif
+#ifdef PORTH
+GPIO_PORT(H)
+#endif
+#ifdef PORTJ
+GPIO_PORT(J)
+#endif
+#ifdef PORTK
+GPIO_PORT(K)
+#endif
+#ifdef PORTL
+GPIO_PORT(L)
+#endif
+
+template<unsigned long cycles>
+inline void delay_cycles() {
+  __builtin_avr_delay_cycles(cycles);
+}
+
+// Wait for 3 * n cycles, with n only known at run time.
+inline void delay_loops(unsigned char n) {
+  if (n) _delay_loop_1(n);
+}
+
+#else
+
+#include "host/gpio.h"
+
+#endif
+
+// Map Arduino pin numbers to port and bit. The tables follow the pins_arduino.h
+// of the respective board. The host simulates a Mega.
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__) || !defined(__AVR__)
+#define GPIO_PIN_TABLE
+static constexpr char GPIO_PORTS[] =
+  "EEEEGEHHHHBBBBJJHHDDDDAAAAAAAACCCCCCCCDGGGLLLLLLLLBBBBFFFFFFFFKKKKKKKK";
+static constexpr unsigned char GPIO_BITS[] = {
+  0, 1, 4, 5, 5, 3, 3, 4, 5, 6, 4, 5, 6, 7, 1, 0,
+  1, 0, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5, 6, 7, 7, 6,
+  5, 4, 3, 2, 1, 0, 7, 2, 1, 0, 7, 6, 5, 4, 3, 2,
+  1, 0, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5, 6, 7, 0, 1,
+  2, 3, 4, 5, 6, 7
+};
+#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+#define GPIO_PIN_TABLE
+static constexpr char GPIO_PORTS[] = "DDDDDDDDBBBBBBCCCCCC";
+static constexpr unsigned char GPIO_BITS[] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 0, 1,
+  2, 3, 4, 5
+};
+#endif
+
+// A pin on a known port and bit.
+template<class Port, int BIT>
+struct GpioPin {
+  static constexpr unsigned char MASK = 1 << BIT;
+  static void high() {
+    Port::ddr() &= ~MASK;
+    Port::port() |= MASK;
+  }
+  static void low() {
+    Port::port() &= ~MASK;
+    Port::ddr() |= MASK;
+  }
+  static bool read() {
+    return Port::pin() & MASK;
+  }
+  static void output() {
+    Port::ddr() |= MASK;
+  }
+  static void set(bool v) {
+    if (v) {
+      Port::port() |= MASK;
+    } else {
+      Port::port() &= ~MASK;
+    }
+  }
+};
+
+#if defined(GPIO_PIN_TABLE)
+
+template<int PIN>
+using Pin = GpioPin<GpioPort<GPIO_PORTS[PIN]>, GPIO_BITS[PIN]>;
+
+#else
+
+// Fall back to the Arduino functions on boards without a pin table.
+template<int PIN>
+struct Pin {
+  static void high() {
+    pinMode(PIN, INPUT_PULLUP);
+  }
+  static void low() {
+    pinMode(PIN, OUTPUT);
+    digitalWrite(PIN, LOW);
+  }
+  static bool read() {
+    return digitalRead(PIN) != LOW;
+  }
+  static void output() {
+    pinMode(PIN, OUTPUT);
+  }
+  static void set(bool v) {
+    digitalWrite(PIN, v ? HIGH : LOW);
+  }
+};
+
+#endif
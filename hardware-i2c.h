@@ -0,0 +1,172 @@
+#pragma once
+
+#if defined(__AVR__)
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/twi.h>
+#else
+#include "host/twi.h"
+#endif
+#include "instrumentation.h"
+
+// The interrupt driven state machine of the TWI peripheral.
+// There is only one TWI, so all of its state is static.
+// This header defines the TWI interrupt and has to be included in only one translation unit.
+class Twi {
+    static constexpr unsigned char IDLE = 0;
+    static constexpr unsigned char BUSY = 1;
+    static constexpr unsigned char FAILED = 2;
+    static constexpr unsigned char CONTROL = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+    static volatile unsigned char state;
+    static unsigned char sla;
+    static int command;
+    static unsigned char *buffer;
+    static volatile unsigned position;
+    static unsigned length;
+    static void stop(unsigned char result) {
+      TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+      state = result;
+    }
+    // Set TWEA if more than one byte is left to read.
+    static void receive() {
+      TWCR = position + 1 < length ? CONTROL | _BV(TWEA) : CONTROL;
+    }
+  public:
+    static bool busy() {
+      return state == BUSY;
+    }
+    static bool result() {
+      return state == IDLE;
+    }
+    static void wait() {
+      while (busy()) {
+#if !defined(__AVR__)
+        host_twi.run();
+#endif
+      }
+    }
+    // Begin a transfer. Unless `command_byte` is negative it is sent before the data.
+    static bool start(unsigned char address_byte, int command_byte, unsigned char *data, unsigned n) {
+      if (busy()) return false;
+      while (TWCR & _BV(TWSTO));
+      sla = address_byte;
+      command = command_byte;
+      buffer = data;
+      position = 0;
+      length = n;
+      state = BUSY;
+      TWCR = CONTROL | _BV(TWSTA);
+      return true;
+    }
+    static void isr() {
+      switch (TW_STATUS) {
+      case TW_START:
+      case TW_REP_START:
+        TWDR = sla;
+        TWCR = CONTROL;
+        break;
+      case TW_MT_SLA_ACK:
+      case TW_MT_DATA_ACK:
+        if (command >= 0) {
+          TWDR = command;
+          command = -1;
+          TWCR = CONTROL;
+        } else if (position < length) {
+          TWDR = buffer[position];
+          position = position + 1;
+          TWCR = CONTROL;
+        } else {
+          stop(IDLE);
+        }
+        break;
+      case TW_MR_SLA_ACK:
+        receive();
+        break;
+      case TW_MR_DATA_ACK:
+        buffer[position] = TWDR;
+        position = position + 1;
+        receive();
+        break;
+      case TW_MR_DATA_NACK:
+        buffer[position] = TWDR;
+        position = position + 1;
+        stop(IDLE);
+        break;
+      case TW_MT_ARB_LOST:
+        TWCR = _BV(TWINT) | _BV(TWEN);
+        state = FAILED;
+        break;
+      default:
+        stop(FAILED);
+        break;
+      }
+    }
+};
+
+volatile unsigned char Twi::state = Twi::IDLE;
+unsigned char Twi::sla;
+int Twi::command;
+unsigned char *Twi::buffer;
+volatile unsigned Twi::position;
+unsigned Twi::length;
+
+ISR(TWI_vect) {
+  Twi::isr();
+}
+
+// I2C on the TWI peripheral with the same interface as `SoftwareI2c`.
+// The `_async` functions return at once and the data has to stay valid until `busy`
+// returns false. Then `result` tells if the transfer went through.
+template<unsigned long frequency = 400000, class Stats = NoBusStats>
+class HardwareI2c : public Stats {
+    static_assert(F_CPU / frequency >= 16, "TWI frequency too high");
+    static_assert((F_CPU / frequency - 16) / 2 < 256, "TWI frequency too low");
+  public:
+    void init() {
+      TWSR = 0;
+      TWBR = (F_CPU / frequency - 16) / 2;
+      TWCR = _BV(TWEN);
+    }
+    // The TWI runs at the fixed `frequency`.
+    bool calibrate(unsigned) {
+      return true;
+    }
+    bool busy() const {
+      return Twi::busy();
+    }
+    bool result() const {
+      return Twi::result();
+    }
+    bool write_async(unsigned address, unsigned char const *data, unsigned length) {
+      return Twi::start(address << 1, -1, (unsigned char *) data, length);
+    }
+    bool write_command_async(unsigned address, unsigned char command_byte, unsigned char const *data, unsigned length) {
+      return Twi::start(address << 1, command_byte, (unsigned char *) data, length);
+    }
+    bool write(unsigned address, unsigned char const *data, unsigned length) {
+      Twi::wait();
+      if (!write_async(address, data, length)) return false;
+      return finish(1 + length);
+    }
+    bool write_command(unsigned address, unsigned char command_byte, unsigned char const *data, unsigned length) {
+      Twi::wait();
+      if (!write_command_async(address, command_byte, data, length)) return false;
+      return finish(2 + length);
+    }
+    bool read(unsigned address, unsigned char *data, unsigned length) {
+      Twi::wait();
+      if (!Twi::start((address << 1) | 1, -1, data, length)) return false;
+      return finish(1 + length);
+    }
+  private:
+    // Wait for a blocking transfer of `bytes` bytes and count it.
+    bool finish(unsigned bytes) {
+      Twi::wait();
+      if (Twi::result()) {
+        this->count_sent(bytes);
+        return true;
+      }
+      this->count_nack();
+      return false;
+    }
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+// A mock of the Arduino core for building the sketch and the drivers on a host.
+// Put this directory on the include path in front of everything else.
+//
+// Pins are the simulated GPIO lines of `host_gpio`, numbered like on a Mega. The clock is
+// `host_gpio.cycles`, which advances with register accesses and delays but not with
+// the computations on the host, so `micros` measures waits and bus time only.
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#include "../gpio.h"
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LED_BUILTIN 13
+
+static const uint8_t SS = 53;
+static const uint8_t MOSI = 51;
+static const uint8_t MISO = 50;
+static const uint8_t SCK = 52;
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const unsigned char *) (p))
+#define pgm_read_word(p) (*(const unsigned short *) (p))
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+inline void pinMode(int pin, int mode) {
+  int p = GPIO_PORTS[pin] - 'A' - (GPIO_PORTS[pin] > 'I');
+  unsigned char m = 1 << GPIO_BITS[pin];
+  if (mode == OUTPUT) {
+    host_gpio.write_ddr(p, host_gpio.read_ddr(p) | m);
+  } else {
+    host_gpio.write_ddr(p, host_gpio.read_ddr(p) & ~m);
+    if (mode == INPUT_PULLUP) {
+      host_gpio.write_port(p, host_gpio.read_port(p) | m);
+    } else {
+      host_gpio.write_port(p, host_gpio.read_port(p) & ~m);
+    }
+  }
+}
+
+inline void digitalWrite(int pin, int v) {
+  int p = GPIO_PORTS[pin] - 'A' - (GPIO_PORTS[pin] > 'I');
+  unsigned char m = 1 << GPIO_BITS[pin];
+  host_gpio.write_port(p, v ? host_gpio.read_port(p) | m : host_gpio.read_port(p) & ~m);
+}
+
+inline int digitalRead(int pin) {
+  int p = GPIO_PORTS[pin] - 'A' - (GPIO_PORTS[pin] > 'I');
+  return host_gpio.read_pin(p) >> GPIO_BITS[pin] & 1 ? HIGH : LOW;
+}
+
+inline unsigned long micros() {
+  return host_gpio.cycles / (F_CPU / 1000000);
+}
+
+inline unsigned long millis() {
+  return host_gpio.cycles / (F_CPU / 1000);
+}
+
+inline void delayMicroseconds(unsigned us) {
+  host_gpio.advance((unsigned long long) us * (F_CPU / 1000000));
+}
+
+inline void delay(unsigned long ms) {
+  host_gpio.advance((unsigned long long) ms * (F_CPU / 1000));
+}
+
+inline void noInterrupts() {}
+inline void interrupts() {}
@@ -0,0 +1,22 @@
+#pragma once
+
+// A storage for `StreamFont` which reads a file, standing in for an SPI flash or an SD
+// card on the host. Counts the reads and bytes, which are the expensive part there.
+
+#include <stdio.h>
+
+class FileStorage {
+    FILE *file;
+  public:
+    unsigned long reads = 0, bytes = 0;
+
+    FileStorage(const char *path) : file(fopen(path, "rb")) {}
+    ~FileStorage() {
+      if (file) fclose(file);
+    }
+    bool read(unsigned long offset, unsigned char *buffer, unsigned length) {
+      ++reads;
+      bytes += length;
+      return file && fseek(file, offset, SEEK_SET) == 0 && fread(buffer, 1, length, file) == length;
+    }
+};
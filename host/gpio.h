@@ -0,0 +1,225 @@
+#pragma once
+
+// Simulated GPIO ports for running the drivers on a host.
+//
+// The ports 'A' to 'L' have DDR, PORT and PIN registers which behave like the ones
+// of an AVR. Every line has an external pull-up, so it is high unless the MCU or a
+// simulated device pulls it down. A released line only reads high after its
+// `rise_cycles`, which models the bus capacitance.
+//
+// Time is counted in CPU cycles. Register writes take two cycles, reads one cycle
+// and `delay_cycles` advances the clock.
+
+#include <vector>
+
+class HostGpio {
+  public:
+    static constexpr int PORTS = 12;
+    // Gets told about every edge on a line.
+    struct Listener {
+      virtual void edge(int port, int bit, bool level) = 0;
+    };
+    unsigned long long cycles = 0;
+    unsigned long writes = 0;
+    unsigned long toggles = 0;
+    unsigned rise_cycles[PORTS][8] = {};
+
+    unsigned char read_ddr(int p) const {
+      return ddr[p];
+    }
+    unsigned char read_port(int p) const {
+      return port[p];
+    }
+    unsigned char read_pin(int p) {
+      advance(1);
+      return level[p];
+    }
+    void write_ddr(int p, unsigned char v) {
+      ddr[p] = v;
+      written(p);
+    }
+    void write_port(int p, unsigned char v) {
+      port[p] = v;
+      written(p);
+    }
+    // Writing ones to PIN toggles PORT.
+    void write_pin(int p, unsigned char v) {
+      port[p] ^= v;
+      written(p);
+    }
+    // The level of a line as seen right now.
+    bool line(int p, int bit) const {
+      return level[p] >> bit & 1;
+    }
+    // Let a simulated device pull a line down or release it.
+    void device_low(int p, int bit, bool low) {
+      if (low) {
+        device[p] |= 1 << bit;
+      } else {
+        device[p] &= ~(1 << bit);
+      }
+      update(p);
+    }
+    void listen(Listener *l) {
+      listeners.push_back(l);
+    }
+    void unlisten(Listener *l) {
+      for (unsigned i = 0; i < listeners.size(); ++i) {
+        if (listeners[i] == l) listeners.erase(listeners.begin() + i);
+      }
+    }
+    // Let time pass and deliver the rising edges which happen meanwhile.
+    void advance(unsigned long long n) {
+      unsigned long long end = cycles + n;
+      int p, b, ep, eb;
+      while (true) {
+        ep = -1;
+        for (p = 0; p < PORTS; ++p) {
+          for (b = 0; b < 8; ++b) {
+            if ((rising[p] >> b & 1) && rise_at[p][b] <= end &&
+                (ep < 0 || rise_at[p][b] < rise_at[ep][eb])) {
+              ep = p;
+              eb = b;
+            }
+          }
+        }
+        if (ep < 0) break;
+        if (rise_at[ep][eb] > cycles) cycles = rise_at[ep][eb];
+        rising[ep] &= ~(1 << eb);
+        set(ep, eb, true);
+      }
+      cycles = end;
+    }
+    // Reset all lines and the clock, but keep the listeners and rise times.
+    void reset() {
+      for (int p = 0; p < PORTS; ++p) {
+        ddr[p] = port[p] = device[p] = rising[p] = 0;
+        level[p] = 0xff;
+      }
+      cycles = 0;
+      writes = 0;
+      toggles = 0;
+    }
+    HostGpio() {
+      reset();
+    }
+  private:
+    unsigned char ddr[PORTS], port[PORTS], device[PORTS], level[PORTS], rising[PORTS];
+    unsigned long long rise_at[PORTS][8];
+    std::vector<Listener *> listeners;
+
+    void written(int p) {
+      ++writes;
+      update(p);
+      advance(2);
+    }
+    void set(int p, int b, bool v) {
+      if (line(p, b) == v) return;
+      if (v) {
+        level[p] |= 1 << b;
+      } else {
+        level[p] &= ~(1 << b);
+      }
+      ++toggles;
+      for (unsigned i = 0; i < listeners.size(); ++i) listeners[i]->edge(p, b, v);
+    }
+    void update(int p) {
+      unsigned char pushed = ddr[p] & port[p];
+      unsigned char pulled = (ddr[p] & ~port[p]) | device[p];
+      for (int b = 0; b < 8; ++b) {
+        bool v = (pushed >> b & 1) || !(pulled >> b & 1);
+        if (!v) {
+          rising[p] &= ~(1 << b);
+          set(p, b, false);
+        } else if (!line(p, b) && !(rising[p] >> b & 1)) {
+          if (rise_cycles[p][b]) {
+            rising[p] |= 1 << b;
+            rise_at[p][b] = cycles + rise_cycles[p][b];
+          } else {
+            set(p, b, true);
+          }
+        }
+      }
+    }
+};
+
+// One simulation shared by all translation units. Before C++17 only a template can
+// define a variable in a header.
+template<class = void>
+struct HostGpioInstance {
+  static HostGpio gpio;
+};
+template<class T>
+HostGpio HostGpioInstance<T>::gpio;
+
+static HostGpio &host_gpio = HostGpioInstance<>::gpio;
+
+enum { HOST_DDR, HOST_PORT, HOST_PIN };
+
+// A simulated register which forwards to `host_gpio`.
+template<int PORT, int KIND>
+struct HostRegister {
+  operator unsigned char() const {
+    if (KIND == HOST_DDR) return host_gpio.read_ddr(PORT);
+    if (KIND == HOST_PORT) return host_gpio.read_port(PORT);
+    return host_gpio.read_pin(PORT);
+  }
+  HostRegister &operator=(unsigned char v) {
+    if (KIND == HOST_DDR) host_gpio.write_ddr(PORT, v);
+    else if (KIND == HOST_PORT) host_gpio.write_port(PORT, v);
+    else host_gpio.write_pin(PORT, v);
+    return *this;
+  }
+  HostRegister &operator|=(unsigned char v) {
+    return *this = (unsigned char) (*this | v);
+  }
+  HostRegister &operator&=(unsigned char v) {
+    return *this = (unsigned char) (*this & v);
+  }
+};
+
+template<char NAME>
+struct GpioPort {
+  static constexpr int INDEX = NAME - 'A' - (NAME > 'I');
+  static HostRegister<INDEX, HOST_DDR> &ddr() {
+    static HostRegister<INDEX, HOST_DDR> r;
+    return r;
+  }
+  static HostRegister<INDEX, HOST_PORT> &port() {
+    static HostRegister<INDEX, HOST_PORT> r;
+    return r;
+  }
+  static HostRegister<INDEX, HOST_PIN> &pin() {
+    static HostRegister<INDEX, HOST_PIN> r;
+    return r;
+  }
+};
+
+template<unsigned long cycles>
+inline void delay_cycles() {
+  host_gpio.advance(cycles);
+}
+
+inline void delay_loops(unsigned char n) {
+  host_gpio.advance(3 * n);
+}
+
+// Records the edges on all lines with their time.
+class GpioTrace : public HostGpio::Listener {
+  public:
+    struct Event {
+      unsigned long long cycles;
+      int port, bit;
+      bool level;
+    };
+    std::vector<Event> events;
+    GpioTrace() {
+      host_gpio.listen(this);
+    }
+    ~GpioTrace() {
+      host_gpio.unlisten(this);
+    }
+    void edge(int port, int bit, bool level) override {
+      events.push_back({host_gpio.cycles, port, bit, level});
+    }
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+// Decodes the I2C traffic on two simulated GPIO lines and plays the devices on the bus.
+//
+// Attached devices answer to their addresses and get the bytes written to them.
+// Acknowledge bits and read data are driven back onto SDA, so the code under test sees
+// a real bus. The counters tell how much traffic went over the bus and for how long.
+
+#include "../gpio.h"
+#include "i2c-device.h"
+
+class I2cBus : public HostGpio::Listener {
+    static constexpr int IDLE = 0;
+    static constexpr int ADDRESS = 1;
+    static constexpr int WRITE = 2;
+    static constexpr int READ = 3;
+    static constexpr int IGNORE = 4;
+    int sda_port, sda_bit, scl_port, scl_bit;
+    I2cDevice *devices[8];
+    int device_count = 0;
+    I2cDevice *current = nullptr;
+    int state = IDLE, count = 0;
+    unsigned char byte = 0;
+    bool driving = false, master_ack = false, addressed = false;
+    unsigned long long started = 0;
+
+    static int port_index(int pin) {
+      return GPIO_PORTS[pin] - 'A' - (GPIO_PORTS[pin] > 'I');
+    }
+    void sda_low(bool low) {
+      driving = low;
+      host_gpio.device_low(sda_port, sda_bit, low);
+    }
+    // Put the next bit of a byte being read on SDA.
+    void send_bit() {
+      sda_low(!(byte & 0x80));
+      byte <<= 1;
+    }
+    void start() {
+      if (state == IDLE) {
+        started = host_gpio.cycles;
+        ++transactions;
+      }
+      state = ADDRESS;
+      count = 0;
+      byte = 0;
+      if (driving) sda_low(false);
+    }
+    void stop() {
+      if (current) current->stop();
+      current = nullptr;
+      if (state != IDLE) bus_cycles += host_gpio.cycles - started;
+      state = IDLE;
+      if (driving) sda_low(false);
+    }
+    // SCL went high, sample SDA.
+    void rising(bool sda) {
+      if (count < 8) {
+        if (state != READ) byte = byte << 1 | sda;
+      } else if (state == READ) {
+        master_ack = !sda;
+      }
+      ++count;
+    }
+    // SCL went low, drive SDA for the next clock.
+    void falling() {
+      bool ack = false;
+      if (count == 8) {
+        ++bytes;
+        if (state == ADDRESS) {
+          for (int i = 0; i < device_count && !current; ++i) {
+            if (devices[i]->address(byte)) current = devices[i];
+          }
+          ack = current;
+          state = !ack ? IGNORE : byte & 1 ? READ : WRITE;
+          addressed = true;
+        } else if (state == WRITE) {
+          ack = current->write(byte);
+        }
+        if (state == READ && !addressed) {
+          sda_low(false);
+        } else {
+          if (!ack) ++nacks;
+          sda_low(ack);
+        }
+      } else if (count == 9) {
+        if (driving) sda_low(false);
+        count = 0;
+        byte = 0;
+        if (state == READ && (addressed || master_ack)) {
+          byte = current->read();
+          send_bit();
+        } else if (state == READ) {
+          state = IGNORE;
+        }
+        addressed = false;
+      } else if (state == READ && count > 0) {
+        send_bit();
+      }
+    }
+  public:
+    unsigned long transactions = 0;
+    unsigned long bytes = 0;
+    unsigned long nacks = 0;
+    // Cycles between START and STOP conditions.
+    unsigned long long bus_cycles = 0;
+
+    I2cBus(int sda, int scl) :
+        sda_port(port_index(sda)), sda_bit(GPIO_BITS[sda]),
+        scl_port(port_index(scl)), scl_bit(GPIO_BITS[scl]) {
+      host_gpio.listen(this);
+    }
+    ~I2cBus() {
+      host_gpio.unlisten(this);
+    }
+    // Let both lines take `cycles` to rise after being released.
+    void rise_time(unsigned cycles) {
+      host_gpio.rise_cycles[sda_port][sda_bit] = cycles;
+      host_gpio.rise_cycles[scl_port][scl_bit] = cycles;
+    }
+    void attach(I2cDevice *device) {
+      devices[device_count++] = device;
+    }
+    void edge(int port, int bit, bool level) override {
+      if (port == sda_port && bit == sda_bit) {
+        // SDA changing while SCL is high is a START or a STOP.
+        if (host_gpio.line(scl_port, scl_bit)) {
+          if (level) {
+            stop();
+          } else {
+            start();
+          }
+        }
+      } else if (port == scl_port && bit == scl_bit && state != IDLE) {
+        if (level) {
+          rising(host_gpio.line(sda_port, sda_bit));
+        } else {
+          falling();
+        }
+      }
+    }
+};
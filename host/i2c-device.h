@@ -0,0 +1,12 @@
+#pragma once
+
+// A simulated device on an I2C bus, driven either by `I2cBus` from the GPIO lines or
+// by the simulated TWI peripheral.
+struct I2cDevice {
+  // Return if the device acknowledges the address byte.
+  virtual bool address(unsigned char sla) = 0;
+  // Return if the device acknowledges the byte.
+  virtual bool write(unsigned char byte) = 0;
+  virtual unsigned char read() = 0;
+  virtual void stop() = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// Decodes the SPI traffic on simulated GPIO lines, for `SoftwareSpi`. Bits are sampled
+// on the rising edge of SCLK, the most significant first. A rising edge of CS, if given,
+// starts a new byte.
+
+#include "spi-device.h"
+
+class SpiBus : public HostGpio::Listener {
+    int sdin_port, sdin_bit, sclk_port, sclk_bit, cs_port, cs_bit;
+    SpiDevice *device = nullptr;
+    int count = 0;
+    unsigned char byte = 0;
+
+    static int port_index(int pin) {
+      return GPIO_PORTS[pin] - 'A' - (GPIO_PORTS[pin] > 'I');
+    }
+  public:
+    unsigned long bytes = 0;
+
+    SpiBus(int sdin, int sclk, int cs = -1) :
+        sdin_port(port_index(sdin)), sdin_bit(GPIO_BITS[sdin]),
+        sclk_port(port_index(sclk)), sclk_bit(GPIO_BITS[sclk]),
+        cs_port(cs < 0 ? -1 : port_index(cs)), cs_bit(cs < 0 ? 0 : GPIO_BITS[cs]) {
+      host_gpio.listen(this);
+    }
+    ~SpiBus() {
+      host_gpio.unlisten(this);
+    }
+    void attach(SpiDevice *d) {
+      device = d;
+    }
+    void edge(int port, int bit, bool level) override {
+      if (port == cs_port && bit == cs_bit && level) {
+        count = 0;
+        byte = 0;
+      } else if (port == sclk_port && bit == sclk_bit && level) {
+        byte = byte << 1 | host_gpio.line(sdin_port, sdin_bit);
+        if (++count == 8) {
+          ++bytes;
+          if (device) device->transfer(byte);
+          count = 0;
+          byte = 0;
+        }
+      }
+    }
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../gpio.h"
+
+// A simulated device on a SPI bus, driven either by `SpiBus` from the GPIO lines or by
+// the simulated SPI peripheral.
+struct SpiDevice {
+  virtual void transfer(unsigned char byte) = 0;
+};
+
+// Plays a 4-wire panel: every byte goes to `command` or `data` of the model, depending
+// on the D/C line. Bytes while CS is high are ignored, CS may be -1 if the panel is
+// always selected.
+template<class Model>
+class SpiPanel : public SpiDevice {
+    Model &model;
+    int dc_port, dc_bit, cs_port, cs_bit;
+    bool last_dc = false;
+
+    static int port_index(int pin) {
+      return GPIO_PORTS[pin] - 'A' - (GPIO_PORTS[pin] > 'I');
+    }
+  public:
+    unsigned long bytes = 0;
+    // How often D/C changed, and how many bytes followed the last change.
+    unsigned long switches = 0;
+    unsigned long run = 0;
+
+    SpiPanel(Model &model, int dc, int cs = -1) :
+        model(model), dc_port(port_index(dc)), dc_bit(GPIO_BITS[dc]),
+        cs_port(cs < 0 ? -1 : port_index(cs)), cs_bit(cs < 0 ? 0 : GPIO_BITS[cs]) {}
+    void transfer(unsigned char byte) override {
+      bool dc;
+      if (cs_port >= 0 && host_gpio.line(cs_port, cs_bit)) return;
+      dc = host_gpio.line(dc_port, dc_bit);
+      if (dc != last_dc) {
+        ++switches;
+        run = 0;
+        last_dc = dc;
+      }
+      ++bytes;
+      ++run;
+      if (dc) {
+        model.data(byte);
+      } else {
+        model.command(byte);
+      }
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+// Simulated SPI peripheral for running `HardwareSpi` on a host.
+//
+// SPCR, SPSR and SPDR behave like the registers of an AVR in master mode. Writing SPDR
+// shifts the byte out at once, hands it to `device` and sets SPIF. The time of the
+// transfer is added to the clock of `host_gpio`.
+
+#include "spi-device.h"
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+#define SPIE 7
+#define SPE 6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+#define SPIF 7
+#define WCOL 6
+#define SPI2X 0
+
+class HostSpi {
+  public:
+    SpiDevice *device = nullptr;
+    unsigned char spcr = 0, spsr = 0, spdr = 0;
+    unsigned long bytes = 0;
+
+    unsigned bit_cycles() const {
+      unsigned d = (spcr & 3) == 3 ? 128 : 4 << 2 * (spcr & 3);
+      return spsr & _BV(SPI2X) ? d / 2 : d;
+    }
+    void write(unsigned char v) {
+      if (!(spcr & _BV(SPE))) return;
+      spsr &= ~_BV(SPIF);
+      ++bytes;
+      if (device) device->transfer(v);
+      spdr = 0xff;
+      host_gpio.advance(8 * bit_cycles());
+      spsr |= _BV(SPIF);
+    }
+};
+
+// One simulation shared by all translation units. Before C++17 only a template can
+// define a variable in a header.
+template<class = void>
+struct HostSpiInstance {
+  static HostSpi spi;
+};
+template<class T>
+HostSpi HostSpiInstance<T>::spi;
+
+static HostSpi &host_spi = HostSpiInstance<>::spi;
+
+enum { HOST_SPCR, HOST_SPSR, HOST_SPDR };
+
+// A simulated register which forwards to `host_spi`.
+template<int KIND>
+struct HostSpiRegister {
+  operator unsigned char() const {
+    if (KIND == HOST_SPCR) return host_spi.spcr;
+    if (KIND == HOST_SPSR) return host_spi.spsr;
+    return host_spi.spdr;
+  }
+  HostSpiRegister &operator=(unsigned char v) {
+    if (KIND == HOST_SPCR) host_spi.spcr = v;
+    else if (KIND == HOST_SPSR) host_spi.spsr = (host_spi.spsr & ~_BV(SPI2X)) | (v & _BV(SPI2X));
+    else host_spi.write(v);
+    return *this;
+  }
+};
+
+static HostSpiRegister<HOST_SPCR> SPCR;
+static HostSpiRegister<HOST_SPSR> SPSR;
+static HostSpiRegister<HOST_SPDR> SPDR;
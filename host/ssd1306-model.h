@@ -0,0 +1,190 @@
+#pragma once
+
+// A simulated SSD1306 controller with a 128x64 panel.
+//
+// It interprets the command and data stream like the controller does, keeps the display
+// RAM and shows which pixels are lit on the panel. Feed it through I2C as an `I2cDevice`,
+// or call `command` and `data` directly for other transports.
+//
+// The panel is assumed to be mounted like on the usual modules, so with segment remap
+// (0xa1) and reversed COM scan (0xc8) the picture equals the RAM contents.
+
+#include <stdio.h>
+#include <string.h>
+#include "i2c-device.h"
+
+class Ssd1306Model : public I2cDevice {
+    unsigned char sla;
+    bool control = true, continuation = false, data_stream = false;
+    unsigned char pending[7];
+    int need = 0, have = 0;
+
+    static int arguments(unsigned char c) {
+      switch (c) {
+      case 0x81: case 0x20: case 0xa8: case 0xd3: case 0xd5:
+      case 0xd9: case 0xda: case 0xdb: case 0x8d:
+        return 1;
+      case 0x21: case 0x22: case 0xa3:
+        return 2;
+      case 0x29: case 0x2a:
+        return 5;
+      case 0x26: case 0x27:
+        return 6;
+      default:
+        return 0;
+      }
+    }
+    void execute() {
+      unsigned char c = pending[0], *a = pending + 1;
+      ++commands;
+      if (c == 0x20) {
+        mode = a[0] & 3;
+      } else if (c == 0x21) {
+        column_start = column = a[0] & 0x7f;
+        column_end = a[1] & 0x7f;
+      } else if (c == 0x22) {
+        page_start = page = a[0] & 7;
+        page_end = a[1] & 7;
+      } else if (c < 0x10) {
+        column = (column & 0xf0) | c;
+      } else if (c < 0x20) {
+        column = (column & 0x0f) | (c & 0x07) << 4;
+      } else if (c >= 0xb0 && c <= 0xb7) {
+        page = c & 7;
+      } else if (c >= 0x40 && c <= 0x7f) {
+        start_line = c & 0x3f;
+      } else if (c == 0xa0 || c == 0xa1) {
+        remap = c & 1;
+      } else if (c == 0xc0 || c == 0xc8) {
+        com_reversed = c & 8;
+      } else if (c == 0xa6 || c == 0xa7) {
+        inverted = c & 1;
+      } else if (c == 0xa4 || c == 0xa5) {
+        entire_on = c & 1;
+      } else if (c == 0xae || c == 0xaf) {
+        on = c & 1;
+      } else if (c == 0x81) {
+        contrast = a[0];
+      } else if (c == 0xd3) {
+        offset = a[0] & 0x3f;
+      } else if (c == 0x26 || c == 0x27 || c == 0x29 || c == 0x2a) {
+        scroll_left = c == 0x27 || c == 0x2a;
+        scroll_first = a[1] & 7;
+        scroll_last = a[3] & 7;
+        scroll_vertical = c >= 0x29 ? a[4] & 0x3f : 0;
+      } else if (c == 0x2e) {
+        scrolling = false;
+      } else if (c == 0x2f) {
+        scrolling = true;
+      }
+    }
+  public:
+    unsigned char ram[1024] = {};
+    int mode = 2, column = 0, page = 0;
+    int column_start = 0, column_end = 127, page_start = 0, page_end = 7;
+    int start_line = 0, offset = 0, contrast = 0x7f;
+    bool remap = false, com_reversed = false, inverted = false, entire_on = false, on = false;
+    bool scrolling = false, scroll_left = false;
+    int scroll_first = 0, scroll_last = 7, scroll_vertical = 0;
+    unsigned long commands = 0, data_bytes = 0;
+
+    Ssd1306Model(unsigned char address = 0x3c) : sla(address) {}
+
+    // Feed one byte of the command stream.
+    void command(unsigned char c) {
+      pending[have++] = c;
+      if (have == 1) need = arguments(c);
+      if (have > need) {
+        execute();
+        have = 0;
+      }
+    }
+    // Write one byte to the display RAM at the current position.
+    void data(unsigned char d) {
+      ++data_bytes;
+      ram[page * 128 + column] = d;
+      if (mode == 0) {
+        if (++column > column_end) {
+          column = column_start;
+          if (++page > page_end) page = page_start;
+        }
+      } else if (mode == 1) {
+        if (++page > page_end) {
+          page = page_start;
+          if (++column > column_end) column = column_start;
+        }
+      } else if (++column > 127) {
+        column = 0;
+      }
+    }
+    // Move the pages in the scroll area by one column, like one step of the controller.
+    void scroll_step() {
+      if (!scrolling) return;
+      for (int p = scroll_first; p <= scroll_last; ++p) {
+        unsigned char *r = ram + p * 128, t;
+        if (scroll_left) {
+          t = r[0];
+          memmove(r, r + 1, 127);
+          r[127] = t;
+        } else {
+          t = r[127];
+          memmove(r + 1, r, 127);
+          r[0] = t;
+        }
+      }
+      start_line = (start_line + scroll_vertical) & 0x3f;
+    }
+    // Whether the pixel at x, y of the panel is lit.
+    bool pixel(int x, int y) const {
+      int row = ((com_reversed ? y : 63 - y) + start_line + offset) & 0x3f;
+      int col = remap ? x : 127 - x;
+      if (!on) return false;
+      if (entire_on) return true;
+      return (ram[(row >> 3) * 128 + col] >> (row & 7) & 1) != inverted;
+    }
+    // The panel contents in the page layout of a frame buffer.
+    void image(unsigned char *buffer) const {
+      memset(buffer, 0, 1024);
+      for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 128; ++x) {
+          if (pixel(x, y)) buffer[(y >> 3) * 128 + x] |= 1 << (y & 7);
+        }
+      }
+    }
+    // Write the panel contents as a PBM image.
+    void write_pbm(FILE *f) const {
+      fprintf(f, "P1\n128 64\n");
+      for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 128; ++x) fputc(pixel(x, y) ? '1' : '0', f);
+        fputc('\n', f);
+      }
+    }
+
+    bool address(unsigned char byte) override {
+      if (byte >> 1 != sla) return false;
+      control = true;
+      return true;
+    }
+    bool write(unsigned char byte) override {
+      if (control) {
+        // Co = 0 means only data follows, Co = 1 means another control byte follows.
+        continuation = byte & 0x80;
+        data_stream = byte & 0x40;
+        control = false;
+      } else {
+        if (data_stream) {
+          data(byte);
+        } else {
+          command(byte);
+        }
+        control = continuation;
+      }
+      return true;
+    }
+    unsigned char read() override {
+      return on ? 0x00 : 0x40;
+    }
+    void stop() override {
+      control = true;
+    }
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+// Simulated TWI peripheral for running `HardwareI2c` on a host.
+//
+// TWBR, TWSR, TWCR and TWDR behave like the registers of an AVR. Writing TWCR with
+// TWINT set performs the requested bus action at once and raises the interrupt
+// flag again; `run` then calls the interrupt handler, like the CPU would.
+// The bus time of every action is added to `cycles`.
+
+#include "i2c-device.h"
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+#define TWINT 7
+#define TWEA 6
+#define TWSTA 5
+#define TWSTO 4
+#define TWWC 3
+#define TWEN 2
+#define TWIE 0
+#define TWPS1 1
+#define TWPS0 0
+
+#define TW_START 0x08
+#define TW_REP_START 0x10
+#define TW_MT_SLA_ACK 0x18
+#define TW_MT_SLA_NACK 0x20
+#define TW_MT_DATA_ACK 0x28
+#define TW_MT_DATA_NACK 0x30
+#define TW_MT_ARB_LOST 0x38
+#define TW_MR_SLA_ACK 0x40
+#define TW_MR_SLA_NACK 0x48
+#define TW_MR_DATA_ACK 0x50
+#define TW_MR_DATA_NACK 0x58
+#define TW_NO_INFO 0xf8
+#define TW_STATUS (TWSR & 0xf8)
+
+#define ISR(vector) inline void vector()
+
+inline void TWI_vect();
+
+class HostTwi {
+  public:
+    using Device = I2cDevice;
+    Device *device = nullptr;
+    unsigned char twbr = 0, twsr = TW_NO_INFO, twcr = 0, twdr = 0;
+    unsigned long long cycles = 0;
+    unsigned long bytes = 0;
+    unsigned long interrupts = 0;
+
+    unsigned long bit_cycles() const {
+      return 16 + 2UL * twbr * (1 << 2 * (twsr & 3));
+    }
+    void control(unsigned char v) {
+      twcr = (twcr & _BV(TWINT)) | (v & ~_BV(TWINT));
+      if (!(v & _BV(TWINT)) || !(v & _BV(TWEN))) return;
+      twcr &= ~_BV(TWINT);
+      if (v & _BV(TWSTA)) {
+        status(owner ? TW_REP_START : TW_START);
+        owner = true;
+        phase = ADDRESS;
+        cycles += bit_cycles();
+      } else if (v & _BV(TWSTO)) {
+        if (device) device->stop();
+        owner = false;
+        twcr &= ~_BV(TWSTO);
+        twsr = (twsr & 3) | TW_NO_INFO;
+        cycles += bit_cycles();
+      } else if (phase == ADDRESS) {
+        bool ack = device && device->address(twdr);
+        phase = twdr & 1 ? READ : WRITE;
+        if (phase == READ) {
+          status(ack ? TW_MR_SLA_ACK : TW_MR_SLA_NACK);
+        } else {
+          status(ack ? TW_MT_SLA_ACK : TW_MT_SLA_NACK);
+        }
+        transferred();
+      } else if (phase == WRITE) {
+        status(device && device->write(twdr) ? TW_MT_DATA_ACK : TW_MT_DATA_NACK);
+        transferred();
+      } else {
+        twdr = device ? device->read() : 0xff;
+        status(v & _BV(TWEA) ? TW_MR_DATA_ACK : TW_MR_DATA_NACK);
+        transferred();
+      }
+    }
+    // Call the interrupt handler if an interrupt is pending.
+    bool run() {
+      if ((twcr & _BV(TWINT)) && (twcr & _BV(TWIE))) {
+        ++interrupts;
+        TWI_vect();
+        return true;
+      }
+      return false;
+    }
+  private:
+    enum { ADDRESS, WRITE, READ } phase = ADDRESS;
+    bool owner = false;
+    void status(unsigned char s) {
+      twsr = (twsr & 3) | s;
+      twcr |= _BV(TWINT);
+    }
+    void transferred() {
+      ++bytes;
+      cycles += 9 * bit_cycles();
+    }
+};
+
+// One simulation shared by all translation units. Before C++17 only a template can
+// define a variable in a header.
+template<class = void>
+struct HostTwiInstance {
+  static HostTwi twi;
+};
+template<class T>
+HostTwi HostTwiInstance<T>::twi;
+
+static HostTwi &host_twi = HostTwiInstance<>::twi;
+
+enum { HOST_TWBR, HOST_TWSR, HOST_TWCR, HOST_TWDR };
+
+// A simulated register which forwards to `host_twi`.
+template<int KIND>
+struct HostTwiRegister {
+  operator unsigned char() const {
+    if (KIND == HOST_TWBR) return host_twi.twbr;
+    if (KIND == HOST_TWSR) return host_twi.twsr;
+    if (KIND == HOST_TWCR) return host_twi.twcr;
+    return host_twi.twdr;
+  }
+  HostTwiRegister &operator=(unsigned char v) {
+    if (KIND == HOST_TWBR) host_twi.twbr = v;
+    else if (KIND == HOST_TWSR) host_twi.twsr = (host_twi.twsr & 0xf8) | (v & 3);
+    else if (KIND == HOST_TWCR) host_twi.control(v);
+    else host_twi.twdr = v;
+    return *this;
+  }
+};
+
+static HostTwiRegister<HOST_TWBR> TWBR;
+static HostTwiRegister<HOST_TWSR> TWSR;
+static HostTwiRegister<HOST_TWCR> TWCR;
+static HostTwiRegister<HOST_TWDR> TWDR;
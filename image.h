@@ -0,0 +1,82 @@
+#pragma once
+
+#include "flash.h"
+
+// Images are arrays of unsigned char in program memory, in the layout of the frame buffer.
+// A header with the width, the height and flags is followed by the pages of the image from
+// top to bottom. Every page has one byte per column and the least significant bit is the
+// topmost row.
+//
+// +-------+--------+-------+--------+--------+-----+
+// | Width | Height | Flags | Page 0 | Page 1 | ... |
+// +-------+--------+-------+--------+--------+-----+
+//   1 Byte  1 Byte  1 Byte  w Bytes  w Bytes
+//
+// With the flag RLE the bytes of all pages are compressed into packets:
+//   0nnnnnnn: n + 1 literal bytes follow.
+//   1nnnnnnn: the next byte is repeated n + 1 times.
+//
+// tools/image.py converts PBM and PNG files into this format.
+class Image {
+    // Reads the bytes of an image one after the other.
+    class Reader {
+        const unsigned char *p;
+        bool rle, run = false;
+        unsigned char count = 0, value = 0;
+      public:
+        Reader(const unsigned char *image) : p(image + 3), rle(flash_byte(image + 2) & RLE) {}
+        unsigned char next() {
+          unsigned char c;
+          if (!rle) return flash_byte(p++);
+          if (!count) {
+            c = flash_byte(p++);
+            run = c & 0x80;
+            count = (c & 0x7f) + 1;
+            if (run) value = flash_byte(p++);
+          }
+          --count;
+          return run ? value : flash_byte(p++);
+        }
+        void skip(int n) {
+          if (!rle) {
+            p += n;
+            return;
+          }
+          while (n-- > 0) next();
+        }
+    };
+    static int _min(int a, int b) {
+      return a > b ? b : a;
+    }
+    static int _max(int a, int b) {
+      return a < b ? b : a;
+    }
+  public:
+    static constexpr unsigned char RLE = 1;
+    static int width(const unsigned char *image) {
+      return flash_byte(image);
+    }
+    static int height(const unsigned char *image) {
+      return flash_byte(image + 1);
+    }
+    // Draw an image with its top left corner at x, y. `mode` is OR, AND or XOR of the
+    // display, as for `blit_column`. Only the visible part is drawn.
+    template<class Display>
+    static void draw(Display &d, const unsigned char *image, int x, int y, int mode = Display::OR) {
+      Reader r(image);
+      int w = width(image), h = height(image), page, c;
+      int c1 = _max(0, -x), c2 = _min(w, (int) d.width() - x);
+      for (page = 0; page * 8 < h; ++page, y += 8) {
+        if (y >= (int) d.height() || c1 >= c2) return;
+        if (y <= -8) {
+          r.skip(w);
+          continue;
+        }
+        r.skip(c1);
+        for (c = c1; c < c2; ++c) {
+          d.blit_column(x + c, y, r.next(), mode, _min(8, h - page * 8));
+        }
+        r.skip(w - c2);
+      }
+    }
+};
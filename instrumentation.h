@@ -0,0 +1,116 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Counters for the traffic of an I2C transport. Pass `BusStats` as the `Stats` parameter
+// of `SoftwareI2c` or `HardwareI2c` and read the counters from the transport, e.g.
+//
+//   static SoftwareI2c<20, 21, 16, false, BusStats> i2c;
+//   ... i2c.nacks ...
+//
+// The default `NoBusStats` has no members, so the counting compiles to nothing.
+struct NoBusStats {
+  void count_sent(unsigned) {}
+  void count_nack() {}
+  void count_retry() {}
+  void count_stretch(unsigned long) {}
+};
+
+struct BusStats {
+  // Bytes which went through, including address and control bytes.
+  unsigned long bytes = 0;
+  // Transfers which were not acknowledged.
+  unsigned long nacks = 0;
+  // Transfers which the driver repeated after a failure.
+  unsigned long retries = 0;
+  // Cycles spent waiting for a device which holds SCL low.
+  unsigned long stretch_cycles = 0;
+  void count_sent(unsigned n) {
+    bytes += n;
+  }
+  void count_nack() {
+    ++nacks;
+  }
+  void count_retry() {
+    ++retries;
+  }
+  void count_stretch(unsigned long cycles) {
+    stretch_cycles += cycles;
+  }
+  void reset_stats() {
+    bytes = nacks = retries = stretch_cycles = 0;
+  }
+};
+
+// Measures the phases of each frame with `micros`, e.g.
+//
+//   profiler.begin(FrameProfiler<>::RENDER);
+//   ... draw ...
+//   profiler.begin(FrameProfiler<>::TRANSFER);
+//   ssd.display(display.data());
+//   profiler.end();
+//
+// Every WINDOW frames the minimum, average and maximum of each phase over these frames
+// are published in `timing`. `NoFrameProfiler` has the same interface and does nothing.
+template<unsigned WINDOW = 16>
+class FrameProfiler {
+  public:
+    static constexpr int RENDER = 0;
+    static constexpr int TRANSFER = 1;
+    static constexpr int FRAME = 2;
+    static constexpr int PHASES = 3;
+    struct Timing {
+      unsigned long min, avg, max;
+    };
+    // Times in microseconds of the last completed window.
+    Timing timing[PHASES] = {};
+    // Start a phase. The previous phase of the frame ends here.
+    void begin(int phase) {
+      unsigned long now = micros();
+      if (current < 0) {
+        frame_start = now;
+      } else {
+        spent[current] += now - phase_start;
+      }
+      current = phase;
+      phase_start = now;
+    }
+    // End the last phase and the frame.
+    void end() {
+      unsigned long now = micros();
+      if (current < 0) return;
+      spent[current] += now - phase_start;
+      spent[FRAME] = now - frame_start;
+      current = -1;
+      for (int p = 0; p < PHASES; ++p) {
+        Window &w = window[p];
+        if (spent[p] < w.min) w.min = spent[p];
+        if (spent[p] > w.max) w.max = spent[p];
+        w.sum += spent[p];
+        spent[p] = 0;
+      }
+      if (++frames < WINDOW) return;
+      for (int p = 0; p < PHASES; ++p) {
+        timing[p] = {window[p].min, window[p].sum / WINDOW, window[p].max};
+        window[p] = {~0UL, 0, 0};
+      }
+      frames = 0;
+    }
+  private:
+    struct Window {
+      unsigned long min, sum, max;
+    };
+    Window window[PHASES] = {{~0UL, 0, 0}, {~0UL, 0, 0}, {~0UL, 0, 0}};
+    unsigned long spent[PHASES] = {};
+    unsigned long frame_start = 0, phase_start = 0;
+    unsigned frames = 0;
+    int current = -1;
+};
+
+struct NoFrameProfiler {
+  static constexpr int RENDER = 0;
+  static constexpr int TRANSFER = 1;
+  static constexpr int FRAME = 2;
+  void begin(int) {}
+  void end() {}
+};
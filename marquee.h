@@ -0,0 +1,67 @@
+#pragma once
+
+// Scrolls tall contents up through an `Ssd1306` row by row, like the credits of a film.
+//
+// The panel moves with the display start line, so nothing has to be sent again when
+// the picture moves. Only the row which leaves the panel at the top is replaced with the
+// row coming in at the bottom, and only in the columns where they differ.
+//
+// The contents are drawn in bands of eight rows by a function `fill(band, n)`, which
+// draws band n into the WIDTH bytes at `band`, e.g. with a `Strip`:
+//
+//   marquee.step([](unsigned char *band, unsigned n) {
+//     strip.begin(n % 12);
+//     list.replay(strip);
+//     memcpy(band, strip.data(), 128);
+//   });
+//
+// n grows with every band, so wrap it around to repeat the contents. Set the start line
+// back to 0 before sending frames again.
+template<class Ssd>
+class Marquee {
+    static constexpr int WIDTH = Ssd::WIDTH;
+    static constexpr int PAGES = Ssd::PAGES;
+    Ssd &ssd;
+    // The band leaving at the top, and the band coming in at the bottom.
+    unsigned char band[2][WIDTH];
+    unsigned top = 0;
+  public:
+    Marquee(Ssd &ssd) : ssd(ssd) {}
+    // The row of the contents at the top of the panel.
+    unsigned position() const {
+      return top;
+    }
+    // Send the first screen of the contents.
+    template<class Fill>
+    bool start(Fill &&fill) {
+      top = 0;
+      ssd.invalidate();
+      for (int p = 0; p < PAGES; ++p) {
+        fill(band[0], p);
+        if (!ssd.window(0, WIDTH - 1, p, p) || !ssd.write(band[0], WIDTH)) return false;
+      }
+      fill(band[0], 0);
+      fill(band[1], PAGES);
+      return ssd.start_line(0);
+    }
+    // Move the contents up by one row.
+    template<class Fill>
+    bool step(Fill &&fill) {
+      unsigned char m = 1 << (top & 7), *o = band[0], *i = band[1];
+      int page = (top >> 3) % PAGES, c1 = 0, c2 = WIDTH, c;
+      while (c1 < c2 && !((o[c1] ^ i[c1]) & m)) ++c1;
+      while (c2 > c1 && !((o[c2 - 1] ^ i[c2 - 1]) & m)) --c2;
+      // The rows of the old band above this one have left the panel already, so the
+      // band becomes what its page in the display RAM holds.
+      for (c = c1; c < c2; ++c) {
+        o[c] ^= (o[c] ^ i[c]) & m;
+      }
+      if (c1 < c2 && (!ssd.window(c1, c2 - 1, page, page) || !ssd.write(o + c1, c2 - c1))) return false;
+      if (!ssd.start_line(++top)) return false;
+      if (!(top & 7)) {
+        fill(band[0], top >> 3);
+        fill(band[1], (top >> 3) + PAGES);
+      }
+      return true;
+    }
+};
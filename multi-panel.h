@@ -0,0 +1,52 @@
+#pragma once
+
+// Shares one bus between several panels, each with its own `FrameTransfer`, e.g.
+//
+//   static Ssd1306<I2cTransport<decltype(i2c)>, true> left{i2c, 0x3c}, right{i2c, 0x3d};
+//   static FrameTransfer<decltype(left)> left_transfer{left}, right_transfer{right};
+//   static MultiPanel<decltype(left_transfer), 2> panels{left_transfer, right_transfer};
+//
+// `show` queues a frame for a panel. `poll` sends one chunk, taking turns between the
+// panels with a frame to send, so every call blocks for one chunk only and no panel
+// waits for the complete frame of another. Panels without a new frame cost nothing,
+// and in shadow mode only the changed parts of a frame go over the bus.
+template<class Transfer, int N>
+class MultiPanel {
+    Transfer *transfers[N];
+    const unsigned char *queued[N] = {};
+    int next = 0;
+  public:
+    template<class... Transfers>
+    MultiPanel(Transfers &... transfers) : transfers{&transfers...} {
+      static_assert(sizeof...(Transfers) == N, "Pass one transfer for each panel");
+    }
+    // Queue a frame for panel i. It must not change until `busy(i)` returns false.
+    // A frame queued while the previous one is still being sent replaces any other
+    // frame waiting for the panel.
+    void show(int i, const unsigned char *frame) {
+      queued[i] = frame;
+    }
+    bool busy(int i) const {
+      return queued[i] || transfers[i]->busy();
+    }
+    bool busy() const {
+      for (int i = 0; i < N; ++i) {
+        if (busy(i)) return true;
+      }
+      return false;
+    }
+    // Send the next chunk for the next panel with something to send.
+    void poll() {
+      for (int k = 0; k < N; ++k) {
+        Transfer &t = *transfers[next];
+        if (!t.busy() && queued[next]) {
+          t.start(queued[next]);
+          queued[next] = nullptr;
+        }
+        bool sent = t.busy();
+        if (sent) t.poll();
+        next = next + 1 < N ? next + 1 : 0;
+        if (sent) return;
+      }
+    }
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "awakening.h"
+
+// A number in a box of fixed width, which only redraws the digits that changed.
+//
+// The box has CELLS cells of the width of a TNUM digit for the sign and the digits, and
+// with DECIMALS a decimal point before the last DECIMALS cells. Numbers are right aligned
+// and values are in units of the last digit, so 1234 shows as 12.34 with DECIMALS = 2.
+// Numbers which do not fit show dashes.
+//
+// `show` returns the area it changed, so only that has to be sent, e.g.
+//
+//   static NumberField<5, 1> temperature{80, 40};
+//   auto a = temperature.show(display, t);
+//   for (int p = a.y1 / 8; a.x1 < a.x2 && p <= (a.y2 - 1) / 8; ++p) {
+//     ssd.update(display.data(), p, a.x1, a.x2);
+//   }
+// The glyphs of the TNUM digits, '-' and '.' for `NumberField`, looked up on first use.
+inline const unsigned char *number_field_glyph(int i) {
+  static const unsigned char *glyphs[12];
+  if (!glyphs[0]) {
+    for (int d = 0; d < 10; ++d) glyphs[d] = Awakening::tnum_glyph(d);
+    glyphs[10] = Awakening::lookup_glyph("-");
+    glyphs[11] = Awakening::lookup_glyph(".");
+  }
+  return glyphs[i];
+}
+
+template<unsigned CELLS, unsigned DECIMALS = 0>
+class NumberField {
+    static_assert(CELLS > DECIMALS, "At least one cell has to be left for the integer part");
+    // The width of a TNUM digit and the space to the next one.
+    static constexpr int CELL = 5;
+    static constexpr int PITCH = CELL + 1;
+    static constexpr int POINT_WIDTH = DECIMALS ? 2 : 0;
+    static constexpr char UNKNOWN = 0;
+    static constexpr int MINUS = 10;
+    static constexpr int POINT = 11;
+    int x, y;
+    // What every cell shows: a digit, '-' or ' ', or UNKNOWN before the first `show`.
+    char shown[CELLS] = {};
+    bool point = false;
+
+    int cell_x(unsigned i) const {
+      return x + i * PITCH + (i >= CELLS - DECIMALS ? POINT_WIDTH : 0);
+    }
+    // Draw a glyph centered in a cell like TNUM does.
+    template<class Display>
+    static void draw_centered(Display &d, const unsigned char *glyph, int x, int y) {
+      if (glyph) Awakening::draw_glyph(d, glyph, x + (CELL - Awakening::glyph_width(glyph)) / 2, y);
+    }
+    // Write the characters of `value` into `cells`.
+    static void format(long value, char *cells) {
+      unsigned long u = value < 0 ? 0UL - value : value;
+      int i = CELLS - 1;
+      for (unsigned j = 0; j < CELLS; ++j) cells[j] = ' ';
+      // The digits, with at least one before the point.
+      do {
+        cells[i--] = '0' + u % 10;
+        u /= 10;
+      } while ((u || i >= (int) (CELLS - DECIMALS - 1)) && i >= 0);
+      if (value < 0) {
+        if (i >= 0) {
+          cells[i] = '-';
+        } else {
+          u = 1;
+        }
+      }
+      if (u) {
+        for (unsigned j = 0; j < CELLS; ++j) cells[j] = '-';
+      }
+    }
+  public:
+    // The area of the display which changed. Empty if x1 == x2.
+    struct Area {
+      int x1, y1, x2, y2;
+    };
+    // The top left corner of the digits is at x, y, like the text of `Awakening`.
+    NumberField(int x, int y) : x(x), y(y) {}
+    static constexpr int width() {
+      return CELLS * PITCH - 1 + POINT_WIDTH;
+    }
+    static constexpr int height() {
+      return 8;
+    }
+    // Draw everything again on the next `show`, e.g. after clearing the display.
+    void invalidate() {
+      for (unsigned i = 0; i < CELLS; ++i) shown[i] = UNKNOWN;
+      point = false;
+    }
+    // Show `value`, redrawing only the cells whose character changed.
+    template<class Display>
+    Area show(Display &d, long value) {
+      char cells[CELLS];
+      Area a = {0, y, 0, y + height()};
+      int cx;
+      format(value, cells);
+      for (unsigned i = 0; i < CELLS; ++i) {
+        if (cells[i] == shown[i]) continue;
+        cx = cell_x(i);
+        if (a.x1 == a.x2) a.x1 = cx;
+        a.x2 = cx + CELL;
+        d.fill_rect(cx, y, cx + CELL, y + height(), 0);
+        if (cells[i] == '-') {
+          draw_centered(d, number_field_glyph(MINUS), cx, y);
+        } else if (cells[i] != ' ') {
+          draw_centered(d, number_field_glyph(cells[i] - '0'), cx, y);
+        }
+        shown[i] = cells[i];
+      }
+      if (DECIMALS && !point) {
+        cx = cell_x(CELLS - DECIMALS) - POINT_WIDTH;
+        d.fill_rect(cx, y, cx + POINT_WIDTH - 1, y + height(), 0);
+        Awakening::draw_glyph(d, number_field_glyph(POINT), cx, y);
+        if (a.x1 == a.x2 || cx < a.x1) a.x1 = cx;
+        if (a.x2 < cx + POINT_WIDTH - 1) a.x2 = cx + POINT_WIDTH - 1;
+        point = true;
+      }
+      return a;
+    }
+};
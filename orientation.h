@@ -0,0 +1,24 @@
+#pragma once
+
+// Orientations of a picture on a panel, as the `orientation` parameter of `Ssd1306` and
+// `Display`. The picture is turned clockwise by the given angle, and with MIRROR it is
+// flipped left to right before that.
+//
+// The controller turns the picture by 180 degrees and mirrors it for free. For 90 and 270
+// degrees `Display` stores the picture transposed, so pass it a width and height which are
+// swapped compared to the panel.
+static constexpr int ROTATE_0 = 0;
+static constexpr int ROTATE_90 = 1;
+static constexpr int ROTATE_180 = 2;
+static constexpr int ROTATE_270 = 3;
+static constexpr int MIRROR = 4;
+
+// If the panel has to show the columns or the rows of the frame buffer in reverse.
+constexpr bool orientation_flip_columns(int orientation) {
+  return ((orientation & 3) == ROTATE_90 || (orientation & 3) == ROTATE_180) !=
+    ((orientation & MIRROR) && !(orientation & 1));
+}
+constexpr bool orientation_flip_rows(int orientation) {
+  return ((orientation & 3) == ROTATE_180 || (orientation & 3) == ROTATE_270) !=
+    ((orientation & MIRROR) && (orientation & 1));
+}
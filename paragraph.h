@@ -0,0 +1,131 @@
+#pragma once
+
+#include "awakening.h"
+
+// Text of several lines, wrapped at spaces to a width. Line feeds start a new line and
+// words longer than a line are broken where they have to.
+//
+// `layout` only breaks the text again if the text pointer, width or options changed,
+// so drawing and scrolling a long message does not measure it again. Call `invalidate`
+// after changing the contents of a text buffer in place, e.g.
+//
+//   static Paragraph<> message;
+//   message.layout(text, 128, Awakening::CENTER);
+//   message.draw(display, 0, 4, 48, scroll);
+template<unsigned MAX_LINES = 16>
+class Paragraph {
+    const char *text = nullptr;
+    int w = 0, options = 0;
+    unsigned count = 0;
+    bool complete = true;
+    // Where every line starts, and where the text ends.
+    const char *starts[MAX_LINES + 1];
+    short widths[MAX_LINES];
+
+    int measure(const char *from, const char *to) const {
+      return Awakening::width(from, to, options & Awakening::TNUM);
+    }
+    static const char *next_char(const char *p) {
+      ++p;
+      while ((*p & 0xc0) == 0x80) ++p;
+      return p;
+    }
+    // Find the end of the line starting at `s`. The width is kept while going, every
+    // word is only measured from the previous one, which keeps the kerning between them.
+    const char *line_end(const char *s) const {
+      const char *p = s, *q, *brk = s, *word = s;
+      int n = 0, m;
+      while (true) {
+        for (q = p; *q && *q != ' ' && *q != '\n'; ++q);
+        if (w > 0 && q > p) {
+          m = n + measure(word, q) - measure(word, brk);
+          if (m > w) break;
+          n = m;
+          word = p;
+        }
+        brk = q;
+        for (p = q; *p == ' '; ++p);
+        if (!*p || *p == '\n') break;
+      }
+      if (brk > s) return brk;
+      // The first word does not fit, take as many characters as fit, at least one. This
+      // measures from the start again, but never more than a line.
+      for (p = s; *p == ' '; ++p);
+      if (!*p || *p == '\n') return p;
+      for (brk = next_char(p), q = brk; *q && *q != ' ' && *q != '\n'; brk = q) {
+        q = next_char(q);
+        if (measure(s, q) > w) break;
+      }
+      return brk;
+    }
+  public:
+    // Break `text` into lines of at most `w` pixels. Returns false if it needs more than
+    // MAX_LINES lines, then only the first MAX_LINES are kept.
+    bool layout(const char *text, int w, int options = Awakening::LEFT) {
+      const char *s = text, *e;
+      if (text == this->text && w == this->w && options == this->options) return complete;
+      this->text = text;
+      this->w = w;
+      this->options = options;
+      count = 0;
+      while (*s && count < MAX_LINES) {
+        if (*s == '\n') {
+          e = s;
+        } else {
+          e = line_end(s);
+        }
+        starts[count] = s;
+        widths[count] = measure(s, e);
+        ++count;
+        // Skip the spaces at the break, or the line feed which ended the line.
+        s = e;
+        if (*s == '\n') {
+          ++s;
+        } else {
+          while (*s == ' ') ++s;
+          if (*s == '\n') ++s;
+        }
+      }
+      starts[count] = s;
+      complete = !*s;
+      return complete;
+    }
+    void invalidate() {
+      text = nullptr;
+    }
+    unsigned lines() const {
+      return count;
+    }
+    // The width of line i.
+    int width(unsigned i) const {
+      return widths[i];
+    }
+    // The text of line i is between `start(i)` and `end(i)`.
+    const char *start(unsigned i) const {
+      return starts[i];
+    }
+    const char *end(unsigned i) const {
+      const char *e = starts[i + 1];
+      while (e > starts[i] && (e[-1] == ' ' || e[-1] == '\n')) --e;
+      return e;
+    }
+    // Draw the lines from line `first` on, aligned between x and x+w of the layout, with
+    // every line `line_height` rows below the previous one. Only lines which fit between
+    // y and y+h completely are drawn. Returns the number of lines drawn.
+    template<class Display>
+    unsigned draw(Display &d, int x, int y, int h, unsigned first = 0, int line_height = 12) {
+      unsigned i, n = 0;
+      int lx;
+      for (i = first; i < count && (int) (i - first + 1) * line_height <= h; ++i, ++n) {
+        lx = x;
+        if (options & Awakening::CENTER) {
+          lx += (w - widths[i]) / 2;
+        } else if (options & Awakening::RIGHT) {
+          lx += w - widths[i];
+        }
+        Awakening::text_range(d, starts[i], end(i), lx, y + (i - first) * line_height,
+                              0, options & Awakening::TNUM);
+      }
+      return n;
+    }
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "gpio.h"
+#include "instrumentation.h"
+
+// If all N pins are on the same port.
+template<int N>
+constexpr bool gpio_same_port(const char (&ports)[N], int i = 1) {
+  return i >= N || (ports[i] == ports[0] && gpio_same_port(ports, i + 1));
+}
+
+// The bits of N pins together.
+template<int N>
+constexpr unsigned char gpio_mask(const unsigned char (&bits)[N], int i = 0) {
+  return i < N ? bits[i] | gpio_mask(bits, i + 1) : 0;
+}
+
+// Several I2C buses with a shared SCL and their own SDA, clocked in lockstep. Every byte
+// goes out on all buses at once, so N devices with the same address get their data in
+// the time of one.
+//
+// All SDA pins have to be on the same port, which is written once per bit. The SDA lines
+// are only ever driven low or released, so they need external pull-ups, as any I2C bus.
+//
+// The functions of `SoftwareI2c` send the same data on all buses and succeed if every
+// device acknowledges. The `_each` functions send different data to each bus and return
+// a mask with bit i set if the device on bus i acknowledged everything.
+template<int SCL, int divider, int... SDA>
+class ParallelSoftwareI2c : public NoBusStats {
+    static constexpr int N = sizeof...(SDA);
+    static_assert(N > 0 && N <= 8, "Between one and eight SDA pins are supported");
+    static constexpr char PORTS[] = {GPIO_PORTS[SDA]...};
+    static_assert(gpio_same_port(PORTS), "All SDA pins have to be on the same port");
+    using Port = GpioPort<PORTS[0]>;
+    using Scl = Pin<SCL>;
+    static constexpr unsigned char BITS[] = {(unsigned char) (1 << GPIO_BITS[SDA])...};
+    static constexpr unsigned char MASK = gpio_mask(BITS);
+    void wait() {
+      delay_cycles<divider>();
+    }
+    // Pull the SDA lines in `low` down and release the others.
+    void sda(unsigned char low) {
+      Port::ddr() = (unsigned char) ((Port::ddr() & ~MASK) | low);
+    }
+    void start() {
+      sda(MASK);
+      wait();
+      Scl::low();
+    }
+    void stop() {
+      sda(MASK);
+      wait();
+      Scl::high();
+      wait();
+      sda(0);
+      wait();
+    }
+    // Write byte i of `bytes` on bus i and return which buses acknowledged.
+    unsigned write_bytes(const unsigned char *bytes) {
+      unsigned char low, pins;
+      unsigned acks = 0;
+      int i, bit;
+      for (bit = 7; bit >= 0; --bit) {
+        low = 0;
+        for (i = 0; i < N; ++i) {
+          if (!(bytes[i] >> bit & 1)) low |= BITS[i];
+        }
+        sda(low);
+        wait();
+        Scl::high();
+        wait();
+        Scl::low();
+      }
+      sda(0);
+      wait();
+      Scl::high();
+      wait();
+      pins = Port::pin();
+      Scl::low();
+      for (i = 0; i < N; ++i) {
+        if (!(pins & BITS[i])) acks |= 1 << i;
+      }
+      return acks;
+    }
+    // Send the address, then the command byte unless it is negative, then the data.
+    // Buses whose device does not acknowledge drop out.
+    unsigned transfer(unsigned address, int command_byte, const unsigned char *const *data, unsigned length) {
+      unsigned char bytes[N];
+      unsigned ok;
+      int i;
+      start();
+      for (i = 0; i < N; ++i) bytes[i] = address << 1;
+      ok = write_bytes(bytes);
+      if (ok && command_byte >= 0) {
+        for (i = 0; i < N; ++i) bytes[i] = command_byte;
+        ok &= write_bytes(bytes);
+      }
+      for (unsigned j = 0; ok && j < length; ++j) {
+        for (i = 0; i < N; ++i) bytes[i] = data[i][j];
+        ok &= write_bytes(bytes);
+      }
+      stop();
+      return ok;
+    }
+  public:
+    static constexpr unsigned ALL = (1 << N) - 1;
+    void init() {
+      Port::port() = (unsigned char) (Port::port() & ~MASK);
+      sda(0);
+      Scl::high();
+      delay_cycles<10 * divider>();
+    }
+    bool calibrate(unsigned) {
+      return true;
+    }
+    unsigned write_each(unsigned address, const unsigned char *const *data, unsigned length) {
+      return transfer(address, -1, data, length);
+    }
+    unsigned write_command_each(unsigned address, unsigned char command_byte, const unsigned char *const *data, unsigned length) {
+      return transfer(address, command_byte, data, length);
+    }
+    bool write(unsigned address, unsigned char const *data, unsigned length) {
+      const unsigned char *all[N];
+      for (int i = 0; i < N; ++i) all[i] = data;
+      return transfer(address, -1, all, length) == ALL;
+    }
+    bool write_command(unsigned address, unsigned char command_byte, unsigned char const *data, unsigned length) {
+      const unsigned char *all[N];
+      for (int i = 0; i < N; ++i) all[i] = data;
+      return transfer(address, command_byte, all, length) == ALL;
+    }
+};
+
+// Before C++17 the array needs a definition outside the class, as it is used at run time.
+template<int SCL, int divider, int... SDA>
+constexpr unsigned char ParallelSoftwareI2c<SCL, divider, SDA...>::BITS[];
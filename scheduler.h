@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Arduino.h>
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#endif
+
+// Draws and sends a frame only when something changed, at most FPS times per second,
+// and puts the MCU to sleep in between.
+//
+// Every part of the screen gets a bit of the dirty mask. `invalidate` marks parts, also
+// from interrupts, and `run` hands the marked parts to the render function, e.g.
+//
+//   static Scheduler<decltype(ssd), decltype(display)> scheduler{ssd, display};
+//
+//   void render(decltype(display) &d, unsigned char dirty) {
+//     if (dirty & CLOCK) draw_clock(d);
+//   }
+//
+//   void loop() {
+//     scheduler.run(render);
+//   }
+//
+// The display keeps its contents between frames, so only the marked parts need to be
+// drawn again.
+//
+// Sleeping uses the idle mode, which keeps the timers running. The timer of `millis`
+// wakes the MCU at least once per millisecond, any other interrupt earlier.
+template<class Ssd, class Display, unsigned FPS = 25>
+class Scheduler {
+    static constexpr unsigned long INTERVAL = 1000000UL / FPS;
+    Ssd &ssd;
+    Display &display;
+    volatile unsigned char dirty = 0;
+    bool started = false;
+    unsigned long last;
+    // Sleep until the next interrupt. Unless `always`, do not sleep when a part is dirty.
+    void sleep(bool always) {
+#if defined(__AVR__)
+      set_sleep_mode(SLEEP_MODE_IDLE);
+      cli();
+      if (always || !dirty) {
+        sleep_enable();
+        // The instruction after sei is executed before any interrupt, so an interrupt
+        // which marks a part cannot slip in before the MCU sleeps.
+        sei();
+        sleep_cpu();
+        sleep_disable();
+      }
+      sei();
+#else
+      // The host sleeps until the next overflow of timer 0.
+      if (always || !dirty) delayMicroseconds(1024);
+#endif
+    }
+  public:
+    Scheduler(Ssd &ssd, Display &display) : ssd(ssd), display(display) {}
+    // Mark parts of the screen to be drawn again.
+    void invalidate(unsigned char parts = 0xff) {
+#if defined(__AVR__)
+      unsigned char s = SREG;
+      cli();
+      dirty |= parts;
+      SREG = s;
+#else
+      dirty |= parts;
+#endif
+    }
+    bool pending() const {
+      return dirty;
+    }
+    // Draw and send a frame if parts are dirty and the last frame is old enough,
+    // otherwise sleep. Returns if a frame was sent.
+    template<class Render>
+    bool run(Render render) {
+      unsigned long now = micros();
+      unsigned char parts;
+      if (!dirty) {
+        sleep(false);
+        return false;
+      }
+      if (started && now - last < INTERVAL) {
+        sleep(true);
+        return false;
+      }
+      noInterrupts();
+      parts = dirty;
+      dirty = 0;
+      interrupts();
+      started = true;
+      last = now;
+      render(display, parts);
+      ssd.display(display.data());
+      return true;
+    }
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+// Outlines and filled shapes for a display type D, drawn from its `hline`, `vline`,
+// `fill_rect` and `pixel`, so they are clipped like those.
+// Filled shapes use vertical spans, which cover whole bytes of a page.
+template<class D>
+class Shapes {
+    D &self() {
+      return *static_cast<D *>(this);
+    }
+    // Order the area and limit the radius to fit it.
+    static bool order(int &x1, int &y1, int &x2, int &y2, int &r) {
+      int t;
+      if (x2 < x1) {
+        t = x2; x2 = x1; x1 = t;
+      }
+      if (y2 < y1) {
+        t = y2; y2 = y1; y1 = t;
+      }
+      if (x1 == x2 || y1 == y2) return false;
+      if (r > (x2 - x1 - 1) / 2) r = (x2 - x1 - 1) / 2;
+      if (r > (y2 - y1 - 1) / 2) r = (y2 - y1 - 1) / 2;
+      if (r < 0) r = 0;
+      return true;
+    }
+  public:
+    // How `blit_column` combines a column with the display.
+    static constexpr int OR = 0;
+    static constexpr int AND = 1;
+    static constexpr int XOR = 2;
+    // Draw the outline of the area between x1, y1 and x2, y2.
+    void rect(int x1, int y1, int x2, int y2, bool v = true) {
+      round_rect(x1, y1, x2, y2, 0, v);
+    }
+    // Draw the outline of the area between x1, y1 and x2, y2 with corners of radius r.
+    void round_rect(int x1, int y1, int x2, int y2, int r, bool v = true) {
+      if (!order(x1, y1, x2, y2, r)) return;
+      // The centers of the corners.
+      int l = x1 + r, rr = x2 - 1 - r, t = y1 + r, b = y2 - 1 - r;
+      int x = 0, y = r, d = 1 - r;
+      self().hline(l, rr, y1, v);
+      self().hline(l, rr, y2 - 1, v);
+      self().vline(x1, t, b, v);
+      self().vline(x2 - 1, t, b, v);
+      while (++x <= y) {
+        if (d < 0) {
+          d += 2 * x + 1;
+        } else {
+          --y;
+          d += 2 * (x - y) + 1;
+        }
+        self().pixel(l - x, t - y, v);
+        self().pixel(rr + x, t - y, v);
+        self().pixel(l - x, b + y, v);
+        self().pixel(rr + x, b + y, v);
+        self().pixel(l - y, t - x, v);
+        self().pixel(rr + y, t - x, v);
+        self().pixel(l - y, b + x, v);
+        self().pixel(rr + y, b + x, v);
+      }
+    }
+    // Paint the area between x1, y1 and x2, y2 with corners of radius r.
+    void fill_round_rect(int x1, int y1, int x2, int y2, int r, bool v = true) {
+      if (!order(x1, y1, x2, y2, r)) return;
+      int l = x1 + r, rr = x2 - 1 - r, t = y1 + r, b = y2 - 1 - r;
+      int x = 0, y = r, d = 1 - r;
+      self().fill_rect(l, y1, rr + 1, y2, v);
+      while (++x <= y) {
+        if (d < 0) {
+          d += 2 * x + 1;
+        } else {
+          // Column y is done, the spans of the next ones are shorter.
+          self().vline(l - y, t - x + 1, b + x - 1, v);
+          self().vline(rr + y, t - x + 1, b + x - 1, v);
+          --y;
+          d += 2 * (x - y) + 1;
+        }
+        self().vline(l - x, t - y, b + y, v);
+        self().vline(rr + x, t - y, b + y, v);
+      }
+    }
+    // Draw a circle around cx, cy.
+    void circle(int cx, int cy, int r, bool v = true) {
+      round_rect(cx - r, cy - r, cx + r + 1, cy + r + 1, r, v);
+    }
+    // Paint a disc around cx, cy.
+    void fill_circle(int cx, int cy, int r, bool v = true) {
+      fill_round_rect(cx - r, cy - r, cx + r + 1, cy + r + 1, r, v);
+    }
+};
@@ -1,73 +1,101 @@
 #pragma once
 
-#include <Arduino.h>
+#include "gpio.h"
+#include "instrumentation.h"
 
-template<int SDA, int SCL, int divider = 10, bool clock_stretching = false>
-class SoftwareI2c {
-    void high(int pin) {
-      pinMode(pin, INPUT_PULLUP);
-    }
-    void low(int pin) {
-      pinMode(pin, OUTPUT);
-      digitalWrite(pin, LOW);
-    }
+// Pass as `divider` to let `calibrate` find the bit period at run time.
+static constexpr int I2C_CALIBRATE = -1;
+
+// With `divider` I2C_CALIBRATE the bit period is chosen by `calibrate`. Repeated NACKs
+// of the calibrated device make it longer, so a bus which starts failing slows down by
+// itself, and a run of good transfers brings it back towards the calibrated period.
+// Other addresses may just have no device, so their NACKs change nothing.
+template<int SDA, int SCL, int divider = 16, bool clock_stretching = false, class Stats = NoBusStats>
+class SoftwareI2c : public Stats {
+    using Sda = Pin<SDA>;
+    using Scl = Pin<SCL>;
+    // No device may answer to this reserved address.
+    static constexpr unsigned RESERVED = 0x7c;
+    // Failed transfers in a row before the bit period gets longer, and good ones before
+    // it gets shorter again.
+    static constexpr unsigned char BACKOFF = 3;
+    static constexpr unsigned char RECOVER = 16;
+    // Half of the bit period in units of three cycles, if calibrated, and the period
+    // `calibrate` found for the device at `device`.
+    unsigned char period = 255, calibrated = 255;
+    unsigned device = 0xff;
+    unsigned char failures = 0, successes = 0;
     void wait() {
-      __builtin_avr_delay_cycles(divider);
+      if constexpr (divider < 0) {
+        delay_loops(period);
+      } else {
+        delay_cycles<divider>();
+      }
     }
-    void wait_high(int pin) {
+    // Release SCL and wait for it to go high.
+    void clock_high() {
+      Scl::high();
       wait();
       if constexpr (clock_stretching) {
-        while (digitalRead(pin) != LOW) wait();
+        while (!Scl::read()) {
+          wait();
+          this->count_stretch(divider < 0 ? 3 * period : divider);
+        }
       }
     }
     void start() {
-      low(SDA);
+      Sda::low();
       wait();
-      low(SCL);
+      Scl::low();
     }
     void stop() {
-      low(SDA);
+      Sda::low();
       wait();
-      high(SCL);
-      wait_high(SCL);
-      high(SDA);
+      clock_high();
+      Sda::high();
       wait();
     }
     void ack() {
-      low(SDA);
+      Sda::low();
       wait();
-      high(SCL);
-      wait_high(SCL);
-      low(SCL);
+      clock_high();
+      Scl::low();
     }
     void nack() {
-      high(SDA);
+      Sda::high();
       wait();
-      high(SCL);
-      wait_high(SCL);
-      low(SCL);
+      clock_high();
+      Scl::low();
     }
     // Write a byte and return if ACK was seen.
     bool write_byte(int byte) {
+      bool a = shift_out(byte);
+      if (a) {
+        this->count_sent(1);
+      } else {
+        this->count_nack();
+      }
+      return a;
+    }
+    // Write a byte without counting it.
+    bool shift_out(int byte) {
       int i, a;
       for (i = 0; i < 8; ++i) {
         if (byte & 128) {
-          high(SDA);
+          Sda::high();
         } else {
-          low(SDA);
+          Sda::low();
         }
         byte <<= 1;
         wait();
-        high(SCL);
-        wait_high(SCL);
-        low(SCL);
+        clock_high();
+        Scl::low();
       }
-      high(SDA);
+      Sda::high();
       wait();
-      high(SCL);
-      wait_high(SCL);
-      a = digitalRead(SDA) == LOW;
-      low(SCL);
+      clock_high();
+      a = !Sda::read();
+      Scl::low();
       return a;
     }
     // Read a byte and return it.
@@ -75,68 +103,112 @@ class SoftwareI2c {
     int read_byte() {
       int i, byte = 0;
       for (i = 0; i < 8; ++i) {
-        high(SDA);
+        Sda::high();
         wait();
-        high(SCL);
-        wait_high(SCL);
-        byte = (byte << 1) | digitalRead(SDA);
-        low(SCL);
+        clock_high();
+        byte = (byte << 1) | Sda::read();
+        Scl::low();
       }
       return byte;
     }
+    // End a transfer to `address` which was not acknowledged.
+    bool fail(unsigned address) {
+      stop();
+      if constexpr (divider < 0) {
+        successes = 0;
+        if (address == device && ++failures >= BACKOFF) {
+          failures = 0;
+          period = period < 204 ? period + period / 4 + 1 : 255;
+        }
+      }
+      return false;
+    }
+    // End a transfer to `address` which went through.
+    bool succeed(unsigned address) {
+      stop();
+      if constexpr (divider < 0) {
+        if (address == device) {
+          failures = 0;
+          if (period > calibrated && ++successes >= RECOVER) {
+            successes = 0;
+            period -= (period - calibrated + 3) / 4;
+          }
+        }
+      }
+      return true;
+    }
+    // Send a few addresses and see if only the device answers.
+    bool probe(unsigned address) {
+      bool a, r;
+      for (int i = 0; i < 8; ++i) {
+        start();
+        a = write_byte(address << 1);
+        stop();
+        start();
+        // The NACK expected here is no error, so it is not counted.
+        r = shift_out(RESERVED << 1);
+        stop();
+        if (!a || r) return false;
+      }
+      return true;
+    }
   public:
     void init() {
-      high(SCL);
-      high(SDA);
-      __builtin_avr_delay_cycles(10 * divider);
+      Scl::high();
+      Sda::high();
+      if constexpr (divider < 0) {
+        for (int i = 0; i < 10; ++i) wait();
+      } else {
+        delay_cycles<10 * divider>();
+      }
     }
-    bool write(unsigned address, unsigned char const *data, unsigned length) {
-      start();
-      if (!write_byte(address << 1)) {
-        stop();
+    // Find the shortest bit period at which the device at `address` answers reliably
+    // and make it half as long again as a margin. Slow rising lines make a NACK look
+    // like an ACK, which the reserved address shows. Does nothing unless `divider` is
+    // I2C_CALIBRATE.
+    bool calibrate(unsigned address) {
+      if constexpr (divider < 0) {
+        for (int p = 1; p < 255; p += p / 8 + 1) {
+          period = p;
+          if (probe(address)) {
+            period = calibrated = p < 169 ? p + p / 2 + 1 : 255;
+            device = address;
+            failures = successes = 0;
+            return true;
+          }
+        }
+        period = calibrated = 255;
         return false;
       }
+      return true;
+    }
+    bool write(unsigned address, unsigned char const *data, unsigned length) {
+      start();
+      if (!write_byte(address << 1)) return fail(address);
       for (unsigned i = 0; i < length; ++i) {
-        if (!write_byte(data[i])) {
-          stop();
-          return false;
-        }
+        if (!write_byte(data[i])) return fail(address);
       }
-      stop();
-      return true;
+      return succeed(address);
     }
     bool write_command(unsigned address, unsigned char command_byte, unsigned char const *data, unsigned length) {
       start();
-      if (!write_byte(address << 1)) {
-        stop();
-        return false;
-      }
-      if (!write_byte(command_byte)) {
-        stop();
-        return false;
-      }
+      if (!write_byte(address << 1)) return fail(address);
+      if (!write_byte(command_byte)) return fail(address);
       for (unsigned i = 0; i < length; ++i) {
-        if (!write_byte(data[i])) {
-          stop();
-          return false;
-        }
+        if (!write_byte(data[i])) return fail(address);
       }
-      stop();
-      return true;
+      return succeed(address);
     }
     bool read(unsigned address, unsigned char *data, unsigned length) {
       start();
-      if (!write_byte((address << 1) | 1)) {
-        stop();
-        return false;
-      }
+      if (!write_byte((address << 1) | 1)) return fail(address);
       unsigned i = 0;
       while (true) {
         data[i++] = read_byte();
         if (i == length) {
           nack();
-          stop();
-          return true;
+          this->count_sent(length);
+          return succeed(address);
         } else {
           ack();
         }
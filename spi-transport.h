@@ -0,0 +1,114 @@
+#pragma once
+
+#include "gpio.h"
+#if defined(__AVR__)
+#include <avr/io.h>
+#else
+#include "host/spi.h"
+#endif
+
+// Transports for `Ssd1306` panels with a 4-wire SPI interface. The D/C line tells
+// commands from display data, so every `command` and `data` goes out as one burst.
+//
+// CS may be -1 if the panel is always selected, RESET may be -1 if it is tied to the
+// reset of the MCU.
+template<int DC, int CS, int RESET>
+class SpiPanelLines {
+  protected:
+    // Make the lines outputs and reset the panel.
+    static void setup() {
+      Pin<DC>::output();
+      if constexpr (CS >= 0) {
+        Pin<CS>::set(true);
+        Pin<CS>::output();
+      }
+      if constexpr (RESET >= 0) {
+        Pin<RESET>::set(false);
+        Pin<RESET>::output();
+        delayMicroseconds(10);
+        Pin<RESET>::set(true);
+        delayMicroseconds(10);
+      }
+    }
+    static void select(bool data) {
+      Pin<DC>::set(data);
+      if constexpr (CS >= 0) Pin<CS>::set(false);
+    }
+    static void deselect() {
+      if constexpr (CS >= 0) Pin<CS>::set(true);
+    }
+};
+
+// The SPI peripheral at half the CPU clock, which is within the 10 MHz of the SSD1306
+// up to 20 MHz CPUs. MOSI and SCK are the fixed pins of the board.
+template<int DC, int CS = -1, int RESET = -1>
+class HardwareSpi : SpiPanelLines<DC, CS, RESET> {
+    static void send(const unsigned char *data, unsigned length) {
+      while (length--) {
+        SPDR = *data++;
+        while (!(SPSR & _BV(SPIF)));
+      }
+    }
+  public:
+    bool init(const unsigned char *sequence, unsigned length) {
+      this->setup();
+      // SS has to be an output, or a low level on it ends master mode.
+      pinMode(SS, OUTPUT);
+      pinMode(MOSI, OUTPUT);
+      pinMode(SCK, OUTPUT);
+      SPCR = _BV(SPE) | _BV(MSTR);
+      SPSR = _BV(SPI2X);
+      return command(sequence, length);
+    }
+    bool command(const unsigned char *data, unsigned length) {
+      this->select(false);
+      send(data, length);
+      this->deselect();
+      return true;
+    }
+    bool data(const unsigned char *data, unsigned length) {
+      this->select(true);
+      send(data, length);
+      this->deselect();
+      return true;
+    }
+};
+
+// Bit-banged SPI on any pins, for boards whose SPI pins are taken.
+template<int SDIN, int SCLK, int DC, int CS = -1, int RESET = -1>
+class SoftwareSpi : SpiPanelLines<DC, CS, RESET> {
+    using Sdin = Pin<SDIN>;
+    using Sclk = Pin<SCLK>;
+    static void send(const unsigned char *data, unsigned length) {
+      unsigned char byte;
+      while (length--) {
+        byte = *data++;
+        for (int i = 0; i < 8; ++i) {
+          Sdin::set(byte & 0x80);
+          Sclk::set(true);
+          Sclk::set(false);
+          byte <<= 1;
+        }
+      }
+    }
+  public:
+    bool init(const unsigned char *sequence, unsigned length) {
+      this->setup();
+      Sclk::set(false);
+      Sclk::output();
+      Sdin::output();
+      return command(sequence, length);
+    }
+    bool command(const unsigned char *data, unsigned length) {
+      this->select(false);
+      send(data, length);
+      this->deselect();
+      return true;
+    }
+    bool data(const unsigned char *data, unsigned length) {
+      this->select(true);
+      send(data, length);
+      this->deselect();
+      return true;
+    }
+};
@@ -1,27 +1,196 @@
 #pragma once
 
+#include <string.h>
+#include "orientation.h"
+
+// A transport sends commands and display data to the controller:
+//
+//   bool init(const unsigned char *sequence, unsigned length);  // set up, send the sequence
+//   bool command(const unsigned char *data, unsigned length);
+//   bool data(const unsigned char *data, unsigned length);
+//
+// `I2cTransport` wraps an I2C bus, spi-transport.h has transports for 4-wire SPI panels.
+
+// Commands and data are transactions to the address of the panel, which start with a
+// control byte telling them apart.
 template<class I2c>
-class Ssd1306 {
-    static constexpr int ADDRESS = 0x3c;
-    static constexpr int COMMAND = 0x00;
-    static constexpr int DATA = 0x40;
+class I2cTransport {
+    static constexpr unsigned char COMMAND = 0x00;
+    static constexpr unsigned char DATA = 0x40;
     I2c &i2c;
+    unsigned char address;
   public:
-    Ssd1306(I2c &i2c) : i2c(i2c) {}
+    // The default address. Panels with SA0 pulled high answer to 0x3d.
+    static constexpr unsigned char ADDRESS = 0x3c;
+    I2cTransport(I2c &i2c, unsigned char address = ADDRESS) : i2c(i2c), address(address) {}
+    // Retry until the panel answers, it may still be powering up.
+    bool init(const unsigned char *sequence, unsigned length) {
+      i2c.init();
+      for (int i = 0; i < 100; ++i) {
+        if (i2c.calibrate(address) && command(sequence, length)) return true;
+        i2c.count_retry();
+      }
+      return false;
+    }
+    bool command(const unsigned char *data, unsigned length) {
+      return i2c.write_command(address, COMMAND, data, length);
+    }
+    bool data(const unsigned char *data, unsigned length) {
+      return i2c.write_command(address, DATA, data, length);
+    }
+    // Send different data to the panel on each bus of a `ParallelSoftwareI2c`.
+    bool data_each(const unsigned char *const *data, unsigned length) {
+      return i2c.write_command_each(address, DATA, data, length) == I2c::ALL;
+    }
+};
+
+// With `shadow` set the driver keeps a copy of what the panel currently shows and
+// `display` only sends the columns which changed.
+//
+// `orientation` sets up the controller to show the frame buffer of a `Display` with the
+// same orientation.
+//
+// The arguments of the constructor are passed on to the transport, e.g.
+//
+//   static Ssd1306<I2cTransport<decltype(i2c)>> ssd{i2c, 0x3d};
+template<class Transport, bool shadow = false, int orientation = ROTATE_0>
+class Ssd1306 {
+    // Over I2C moving the address window costs a command transaction of eight bytes and a
+    // new data transaction of two bytes. Gaps shorter than that are cheaper to resend.
+    static constexpr int GAP = 10;
+    Transport transport;
+    unsigned char panel[shadow ? 1024 : 1];
+    // One bit for each page whose copy in `panel` is up to date.
+    unsigned char known = 0;
+    // Like std::declval, which is not there on the board.
+    template<class T>
+    static T &&argument();
+  public:
+    static constexpr int WIDTH = 128;
+    static constexpr int PAGES = 8;
+    static constexpr bool SHADOW = shadow;
+    // Only arguments which make a Transport, so a copy still uses the copy constructor.
+    template<class... Args, class = decltype(Transport(argument<Args>()...))>
+    Ssd1306(Args &&... args) : transport(static_cast<Args &&>(args)...) {}
     bool init() {
       static unsigned char const init_sequence[] = {
         0xae, 0xd5, 0x80, 0xa8, 0x3f, 0xd3, 0x00, 0x40,
-        0x8d, 0x14, 0x20, 0x00, 0xa1, 0xc8, 0xda, 0x12,
+        0x8d, 0x14, 0x20, 0x00,
+        orientation_flip_columns(orientation) ? 0xa0 : 0xa1,
+        orientation_flip_rows(orientation) ? 0xc0 : 0xc8,
+        0xda, 0x12,
         0x81, 0xcf, 0xd9, 0xf1, 0xdb, 0x40, 0xa4, 0xa6,
         0x21, 0x00, 0x7f, 0x22, 0x00, 0x07, 0x2e, 0xaf
       };
-      i2c.init();
-      for (int i = 0; i < 100; ++i) {
-        if (i2c.write_command(ADDRESS, COMMAND, init_sequence, sizeof(init_sequence))) return true;
+      known = 0;
+      return transport.init(init_sequence, sizeof(init_sequence));
+    }
+    // Restrict the following writes to columns c1 to c2 and pages p1 to p2 (inclusive).
+    bool window(int c1, int c2, int p1, int p2) {
+      unsigned char const sequence[] = {
+        0x21, (unsigned char) c1, (unsigned char) c2,
+        0x22, (unsigned char) p1, (unsigned char) p2
+      };
+      return transport.command(sequence, sizeof(sequence));
+    }
+    // Write display data at the current position in the window.
+    bool write(const unsigned char *data, unsigned length) {
+      return transport.data(data, length);
+    }
+    // Send columns c1 to c2 (exclusive) of a page from a full frame buffer.
+    // In shadow mode only the runs which differ from the panel are sent. Pages whose
+    // contents are not known are sent completely.
+    bool update(const unsigned char *buffer, int page, int c1, int c2) {
+      int o = page * WIDTH, c, start, end;
+      if constexpr (shadow) {
+        if (!(known >> page & 1)) {
+          if (!window(0, WIDTH - 1, page, page) || !write(buffer + o, WIDTH)) return false;
+          memcpy(panel + o, buffer + o, WIDTH);
+          known |= 1 << page;
+          return true;
+        }
+        for (c = c1; c < c2;) {
+          if (buffer[o + c] == panel[o + c]) {
+            ++c;
+            continue;
+          }
+          start = c;
+          end = c + 1;
+          for (++c; c < c2 && c - end <= GAP; ++c) {
+            if (buffer[o + c] != panel[o + c]) end = c + 1;
+          }
+          if (!window(start, end - 1, page, page) || !write(buffer + o + start, end - start)) {
+            known &= ~(1 << page);
+            return false;
+          }
+          memcpy(panel + o + start, buffer + o + start, end - start);
+          c = end;
+        }
+        return true;
+      } else {
+        return window(c1, c2 - 1, page, page) && write(buffer + o + c1, c2 - c1);
       }
-      return false;
     }
+    // Forget what the panel shows, so the next frame is sent completely in shadow mode.
+    // Call this after changing the panel with `window` and `write` directly.
+    void invalidate() {
+      known = 0;
+    }
+    // Let the controller move pages p1 to p2 by one column every `interval` frames.
+    // `interval` is a code from the datasheet: 7 is the fastest with 2 frames, 4 gives 3,
+    // 5 gives 4, 0 gives 5, 6 gives 25, 1 gives 64, 2 gives 128 and 3 gives 256 frames.
+    // With `vertical` the whole display also moves up by that many rows every step.
+    // The panel contents are lost when scrolling stops, so send a full frame afterwards.
+    bool scroll(bool left, int p1, int p2, int interval = 7, int vertical = 0) {
+      unsigned char const horizontal[] = {
+        0x2e, (unsigned char) (0x26 + left), 0x00,
+        (unsigned char) p1, (unsigned char) interval, (unsigned char) p2, 0x00, 0xff, 0x2f
+      };
+      unsigned char const diagonal[] = {
+        0x2e, (unsigned char) (0x29 + left), 0x00,
+        (unsigned char) p1, (unsigned char) interval, (unsigned char) p2, (unsigned char) vertical, 0x2f
+      };
+      known = 0;
+      if (vertical) return transport.command(diagonal, sizeof(diagonal));
+      return transport.command(horizontal, sizeof(horizontal));
+    }
+    // Restrict vertical scrolling to `rows` rows starting at row `top`.
+    bool scroll_area(int top, int rows) {
+      unsigned char const sequence[] = {0xa3, (unsigned char) top, (unsigned char) rows};
+      return transport.command(sequence, sizeof(sequence));
+    }
+    bool stop_scroll() {
+      unsigned char const sequence[] = {0x2e};
+      known = 0;
+      return transport.command(sequence, sizeof(sequence));
+    }
+    // Show row `line` of the display RAM at the top of the panel. The rows above it
+    // follow at the bottom.
+    bool start_line(int line) {
+      unsigned char const sequence[] = {(unsigned char) (0x40 | (line & 0x3f))};
+      return transport.command(sequence, sizeof(sequence));
+    }
+    // Send a full frame. In shadow mode only the changed parts are sent.
     void display(const unsigned char *buffer) {
-      i2c.write_command(ADDRESS, DATA, buffer, 1024);
+      if constexpr (shadow) {
+        if (known) {
+          for (int p = 0; p < PAGES; ++p) {
+            if (!update(buffer, p, 0, WIDTH)) break;
+          }
+          if (known == (1 << PAGES) - 1) return;
+        }
+        known = 0;
+        if (window(0, WIDTH - 1, 0, PAGES - 1) && write(buffer, WIDTH * PAGES)) {
+          memcpy(panel, buffer, sizeof(panel));
+          known = (1 << PAGES) - 1;
+        }
+      } else {
+        window(0, WIDTH - 1, 0, PAGES - 1) && write(buffer, WIDTH * PAGES);
+      }
+    }
+    // Send a different full frame to the panel on each bus of a `ParallelSoftwareI2c`.
+    bool display_each(const unsigned char *const *buffers) {
+      known = 0;
+      return window(0, WIDTH - 1, 0, PAGES - 1) && transport.data_each(buffers, WIDTH * PAGES);
     }
-};
\ No newline at end of file
+};
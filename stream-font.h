@@ -0,0 +1,262 @@
+#pragma once
+
+#include "flash.h"
+
+// Fonts which are too large for program memory, read glyph by glyph from a storage
+// such as an SPI flash or an SD card. Recently used glyphs are kept in a small cache.
+//
+// A storage only has to read bytes at an offset:
+//
+//   bool read(unsigned long offset, unsigned char *buffer, unsigned length);
+//
+// `ProgmemStorage` reads a font in program memory, host/file-storage.h reads a file.
+//
+// All numbers are little endian. A font starts with a header and the ranges of code
+// points which have glyphs, sorted by their first code point. The glyphs of a range are
+// consecutive in the offset table.
+// +------+--------+-------+--------+--------+-------+-------+-----+---------+---------+-----+
+// | "SF" | Height | Space | Ranges | Glyphs | Range | Range | ... | Offset  | Offset  | ... |
+// +------+--------+-------+--------+--------+-------+-------+-----+---------+---------+-----+
+//  2 Bytes 1 Byte  1 Byte  2 Bytes  2 Bytes  8 Bytes                4 Bytes
+//
+// A range holds its first code point (4 bytes), the number of code points (2 bytes) and
+// the number of its first glyph (2 bytes). An offset is where a glyph starts in the font.
+//
+// A glyph is its width in columns followed by the columns. A column has one byte for
+// every 8 rows of the height, the least significant bit of the first byte is the topmost
+// row. Fonts can be up to 32 pixels high.
+//
+// tools/fontc.py converts BDF and PNG fonts into this format.
+
+// Reads a font which is an array of unsigned char in program memory.
+class ProgmemStorage {
+    const unsigned char *font;
+  public:
+    ProgmemStorage(const unsigned char *font) : font(font) {}
+    bool read(unsigned long offset, unsigned char *buffer, unsigned length) {
+      while (length--) *buffer++ = flash_byte(font + offset++);
+      return true;
+    }
+};
+
+// Draws text in a font from `Storage`. The cache holds SLOTS glyphs of up to SLOT_BYTES
+// bytes of columns each. Larger glyphs are drawn straight from the storage.
+//
+// The cache takes SLOTS * (SLOT_BYTES + 7) bytes of RAM, 156 with the defaults, which
+// fit four glyphs of 16 pixels and 16 columns. Raise them for larger fonts if the RAM
+// allows.
+template<class Storage, unsigned SLOTS = 4, unsigned SLOT_BYTES = 32>
+class StreamFont {
+    static constexpr unsigned long NONE = 0xffffffff;
+    static constexpr unsigned long REPLACEMENT = 0xfffd;
+    static constexpr int HEADER = 8;
+    static constexpr int RANGE = 8;
+    struct Slot {
+      unsigned long codepoint = NONE;
+      unsigned short used = 0;
+      unsigned char width = 0;
+      unsigned char columns[SLOT_BYTES];
+    };
+    Storage &storage;
+    unsigned char rows = 0, space = 0, column_bytes = 0;
+    unsigned short ranges = 0, glyphs = 0;
+    unsigned short clock = 0;
+    Slot slots[SLOTS];
+
+    static unsigned long little_endian(const unsigned char *p, int n) {
+      unsigned long v = 0;
+      while (n--) v = v << 8 | p[n];
+      return v;
+    }
+    // Find where the glyph of a code point starts, or return 0.
+    unsigned long locate(unsigned long codepoint) {
+      unsigned char range[RANGE], offset[4];
+      unsigned long first, number;
+      int lo = 0, hi = ranges, mid;
+      // Find the last range which starts at or before the code point.
+      while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (!storage.read(HEADER + (unsigned long) mid * RANGE, range, 4)) return 0;
+        if (little_endian(range, 4) <= codepoint) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      if (!lo || !storage.read(HEADER + (unsigned long) (lo - 1) * RANGE, range, RANGE)) return 0;
+      first = little_endian(range, 4);
+      if (codepoint - first >= little_endian(range + 4, 2)) return 0;
+      number = little_endian(range + 6, 2) + codepoint - first;
+      if (number >= glyphs) return 0;
+      if (!storage.read(HEADER + (unsigned long) ranges * RANGE + 4 * number, offset, 4)) return 0;
+      return little_endian(offset, 4);
+    }
+    // Return the cached glyph of a code point, loading it if needed. Returns nullptr if
+    // the font has no such glyph or it is too large for a slot, then `offset` is where
+    // it starts, or 0.
+    Slot *glyph(unsigned long codepoint, unsigned long &offset) {
+      Slot *slot = slots;
+      unsigned char width;
+      offset = 0;
+      for (unsigned i = 0; i < SLOTS; ++i) {
+        if (slots[i].codepoint == codepoint) {
+          ++hits;
+          slots[i].used = ++clock;
+          return slots + i;
+        }
+        // Unsigned differences keep the order right when the clock wraps.
+        if ((unsigned short) (clock - slots[i].used) > (unsigned short) (clock - slot->used)) slot = slots + i;
+      }
+      ++misses;
+      offset = locate(codepoint);
+      if (!offset || !storage.read(offset, &width, 1)) {
+        offset = 0;
+        return nullptr;
+      }
+      if ((unsigned) width * column_bytes > SLOT_BYTES) return nullptr;
+      // Overwrite the least recently used slot.
+      slot->codepoint = NONE;
+      if (!storage.read(offset + 1, slot->columns, width * column_bytes)) {
+        offset = 0;
+        return nullptr;
+      }
+      slot->codepoint = codepoint;
+      slot->width = width;
+      slot->used = ++clock;
+      return slot;
+    }
+    template<class Display>
+    void draw_column(Display &d, int x, int y, const unsigned char *column) {
+      unsigned long bits = little_endian(column, column_bytes);
+      for (int r = 0; r < rows; r += 16, bits >>= 16) {
+        d.blit_column(x, y + r, bits & 0xffff, Display::OR, rows - r < 16 ? rows - r : 16);
+      }
+    }
+    // The width of the glyph of a code point, or -1 if the font has none.
+    int width(unsigned long codepoint) {
+      unsigned long offset;
+      unsigned char width;
+      Slot *slot = glyph(codepoint, offset);
+      if (slot) return slot->width;
+      if (!offset || !storage.read(offset, &width, 1)) return -1;
+      return width;
+    }
+    // Draw the glyph of a code point with its top left corner at x, y.
+    template<class Display>
+    void draw_glyph(Display &d, unsigned long codepoint, int x, int y) {
+      unsigned char column[4];
+      unsigned long offset;
+      Slot *slot = glyph(codepoint, offset);
+      int i, cols;
+      if (slot) {
+        cols = _min(slot->width, (int) d.width() - x);
+        for (i = _max(0, -x); i < cols; ++i) {
+          draw_column(d, x + i, y, slot->columns + i * column_bytes);
+        }
+        return;
+      }
+      if (!offset || !storage.read(offset, column, 1)) return;
+      cols = _min(column[0], (int) d.width() - x);
+      for (i = _max(0, -x); i < cols; ++i) {
+        if (!storage.read(offset + 1 + (unsigned long) i * column_bytes, column, column_bytes)) return;
+        draw_column(d, x + i, y, column);
+      }
+    }
+    // Typeset a line of text with a maximum width of `w` and call `place(codepoint, x)`
+    // for every glyph. Return the width used.
+    template<class Place>
+    int layout(const char *text, int w, Place place) {
+      int n = 0, cols, gap;
+      unsigned long codepoint;
+      while (*text) {
+        codepoint = decode(text);
+        if (codepoint == ' ') {
+          if (w > 0 && n + space >= w) return n;
+          n += space;
+          continue;
+        }
+        cols = width(codepoint);
+        if (cols < 0) {
+          codepoint = REPLACEMENT;
+          cols = width(codepoint);
+        }
+        if (cols < 0) continue;
+        gap = n ? 1 : 0;
+        if (w > 0 && n + gap + cols > w) return n;
+        n += gap;
+        place(codepoint, n);
+        n += cols;
+      }
+      return n;
+    }
+    static int _min(int a, int b) {
+      return a > b ? b : a;
+    }
+    static int _max(int a, int b) {
+      return a < b ? b : a;
+    }
+  public:
+    static constexpr int LEFT = 0;
+    static constexpr int RIGHT = 1;
+    static constexpr int CENTER = 2;
+    // Glyphs found in and missing from the cache.
+    unsigned long hits = 0, misses = 0;
+
+    StreamFont(Storage &storage) : storage(storage) {}
+    // Read the header of the font. Returns false if the storage does not hold a font.
+    bool begin() {
+      unsigned char header[HEADER];
+      for (unsigned i = 0; i < SLOTS; ++i) slots[i].codepoint = NONE;
+      if (!storage.read(0, header, HEADER) || header[0] != 'S' || header[1] != 'F') return false;
+      if (!header[2] || header[2] > 32) return false;
+      rows = header[2];
+      space = header[3];
+      column_bytes = (rows + 7) / 8;
+      ranges = little_endian(header + 4, 2);
+      glyphs = little_endian(header + 6, 2);
+      return true;
+    }
+    int height() const {
+      return rows;
+    }
+    // Decode the UTF-8 sequence at `text` and move past it. Malformed sequences become
+    // U+FFFD.
+    static unsigned long decode(const char *&text) {
+      unsigned char c = *text++;
+      unsigned long codepoint;
+      int n;
+      if (c < 0x80) return c;
+      if (c < 0xc0) return REPLACEMENT;
+      n = c < 0xe0 ? 1 : c < 0xf0 ? 2 : 3;
+      codepoint = c & (0x3f >> n);
+      while (n--) {
+        if ((*text & 0xc0) != 0x80) return REPLACEMENT;
+        codepoint = codepoint << 6 | (*text++ & 0x3f);
+      }
+      return codepoint;
+    }
+    // Typeset a line of text with its top left corner at x, y and a maximum width of `w`,
+    // or no limit if `w` is 0. Code points without a glyph are drawn as U+FFFD, if the
+    // font has it, and skipped otherwise. Return the width used.
+    template<class Display>
+    int text(Display &d, const char *text, int x, int y, int w = 0) {
+      return text_with_options(d, text, x, y, w, LEFT);
+    }
+    // Typeset a line of text aligned between x and x+w.
+    template<class Display>
+    int text_with_options(Display &d, const char *text, int x, int y, int w, int options) {
+      int n;
+      if (options & (CENTER | RIGHT)) {
+        // The glyphs are cached by now, unless the line has more than SLOTS different ones.
+        n = measure(text, w);
+        x += options & CENTER ? (w - n) / 2 : w - n;
+      }
+      return layout(text, w, [&](unsigned long codepoint, int n) {
+        draw_glyph(d, codepoint, x + n, y);
+      });
+    }
+    // The width of a line of text.
+    int measure(const char *text, int w = 0) {
+      return layout(text, w, [](unsigned long, int) {});
+    }
+};
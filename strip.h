@@ -0,0 +1,160 @@
+#pragma once
+
+#include <string.h>
+#include "shapes.h"
+
+// A display which only holds one page, that is eight rows, of a WIDTH x HEIGHT display.
+// It draws like `Display`, but everything outside of the current page is clipped.
+// Draw the same things once for every page to get the same picture as with a full
+// frame buffer, e.g. by replaying a `DisplayList`.
+template<unsigned WIDTH, unsigned HEIGHT>
+class Strip : public Shapes<Strip<WIDTH, HEIGHT>> {
+    unsigned char buffer[WIDTH];
+    int top = 0;
+  public:
+    using Shapes<Strip>::OR;
+    using Shapes<Strip>::AND;
+    using Shapes<Strip>::XOR;
+    static constexpr int PAGES = HEIGHT / 8;
+    unsigned width() const {
+      return WIDTH;
+    }
+    unsigned height() const {
+      return HEIGHT;
+    }
+    const unsigned char *data() const {
+      return buffer;
+    }
+    int page() const {
+      return top >> 3;
+    }
+    // Start drawing the given page. Makes all its pixels black if v == 0, white otherwise.
+    void begin(int page, bool v = false) {
+      top = page * 8;
+      memset(buffer, v ? 0xff : 0x00, sizeof(buffer));
+    }
+    // Invert everything in the area between x1, y1 and x2, y2.
+    void invert(int x1, int y1, int x2, int y2) {
+      area(x1, y1, x2, y2, INVERT);
+    }
+    // Paint everything in the area between x1, y1 and x2, y2.
+    // Paint black if v == 0, white otherwise.
+    void fill_rect(int x1, int y1, int x2, int y2, int v) {
+      area(x1, y1, x2, y2, v ? SET : CLEAR);
+    }
+    // Draw a horizontal line from x1 to x2 (inclusive) in row y.
+    void hline(int x1, int x2, int y, bool v = true) {
+      if (x2 < x1) {
+        int t = x2; x2 = x1; x1 = t;
+      }
+      area(x1, y, x2 + 1, y + 1, v ? SET : CLEAR);
+    }
+    // Draw a vertical line from y1 to y2 (inclusive) in column x.
+    void vline(int x, int y1, int y2, bool v = true) {
+      if (y2 < y1) {
+        int t = y2; y2 = y1; y1 = t;
+      }
+      area(x, y1, x + 1, y2 + 1, v ? SET : CLEAR);
+    }
+    // Set the pixel at position x, y to value v (0 or 1).
+    void pixel(int x, int y, bool v = true) {
+      y -= top;
+      if (x < 0 || x >= (int) WIDTH || y < 0 || y >= 8) return;
+      if (v) {
+        buffer[x] |= 1 << y;
+      } else {
+        buffer[x] &= ~(1 << y);
+      }
+    }
+    // Paint the pixels set in a column of up to 16 pixels white.
+    // Bit 0 of `bits` is the pixel at x, y and the column extends downwards.
+    // With `mode` AND or XOR the `height` topmost pixels of the column are combined with
+    // the display that way instead.
+    void blit_column(int x, int y, unsigned bits, int mode = OR, int height = 16) {
+      unsigned long m = (1UL << height) - 1;
+      unsigned char v;
+      y -= top;
+      if (x < 0 || x >= (int) WIDTH || y >= 8 || y <= -height) return;
+      v = y < 0 ? bits >> -y : bits << y;
+      m = y < 0 ? m >> -y : m << y;
+      if (mode == OR) {
+        buffer[x] |= v;
+      } else if (mode == XOR) {
+        buffer[x] ^= v;
+      } else {
+        buffer[x] &= v | ~m;
+      }
+    }
+    // Draw a straight line from x1, y1 to x2, y2.
+    void line(int x1, int y1, int x2, int y2) {
+      if (y1 == y2) return hline(x1, x2, y1);
+      if (x1 == x2) return vline(x1, y1, y2);
+      int dx = _abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+      int dy = _abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+      int err = (dx > dy ? dx : -dy) / 2, e2;
+      while (true) {
+        pixel(x1, y1, 1);
+        if (x1 == x2 && y1 == y2) break;
+        e2 = err;
+        if (e2 >-dx) { err -= dy; x1 += sx; }
+        if (e2 < dy) { err += dx; y1 += sy; }
+      }
+    }
+    // Makes all pixels of the page black if v == 0, white otherwise.
+    void clear(bool v = false) {
+      memset(buffer, v ? 0xff : 0x00, sizeof(buffer));
+    }
+    // Draw everything in `list` page by page and send the pages to `ssd` as they are done.
+    template<class Ssd, class List>
+    bool render(Ssd &ssd, const List &list, bool v = false) {
+      bool ok = true;
+      for (int p = 0; p < PAGES; ++p) {
+        begin(p, v);
+        list.replay(*this, top, top + 8);
+        ok = ssd.window(0, WIDTH - 1, p, p) && ssd.write(buffer, WIDTH) && ok;
+      }
+      return ok;
+    }
+  private:
+    static constexpr int CLEAR = 0;
+    static constexpr int SET = 1;
+    static constexpr int INVERT = 2;
+    // Order and clip the area like `Display` does and apply `op` to its rows in the
+    // current page.
+    void area(int x1, int y1, int x2, int y2, int op) {
+      int t, r = top >> 3, c;
+      unsigned char m;
+      if (x2 < x1) {
+        t = x2; x2 = x1; x1 = t;
+      }
+      if (y2 < y1) {
+        t = y2; y2 = y1; y1 = t;
+      }
+      x1 = _min(_max(x1, 0), WIDTH);
+      y1 = _min(_max(y1, 0), HEIGHT);
+      x2 = _min(_max(x2, 0), WIDTH);
+      y2 = _min(_max(y2, 0), HEIGHT);
+      if (x1 == x2 || y1 == y2 || r < y1 >> 3 || r > (y2 - 1) >> 3) return;
+      m = 0xff;
+      if (r == y1 >> 3) m &= 0xff << (y1 & 7);
+      if (r == (y2 - 1) >> 3) m &= 0xff >> (7 - ((y2 - 1) & 7));
+      if (op == INVERT) {
+        for (c = x1; c < x2; ++c) buffer[c] ^= m;
+      } else if (m == 0xff) {
+        memset(buffer + x1, op == SET ? 0xff : 0x00, x2 - x1);
+      } else if (op == SET) {
+        for (c = x1; c < x2; ++c) buffer[c] |= m;
+      } else {
+        for (c = x1; c < x2; ++c) buffer[c] &= ~m;
+      }
+    }
+    int _max(int a, int b) {
+      return a < b ? b : a;
+    }
+    int _min(int a, int b) {
+      return a > b ? b : a;
+    }
+    int _abs(int a) {
+      return a < 0 ? -a : a;
+    }
+};
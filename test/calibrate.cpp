@@ -0,0 +1,95 @@
+// Calibrates `SoftwareI2c` on simulated buses with slow rising lines, and checks that
+// the bit period backs off after repeated failures of the panel and recovers after.
+
+#include <Arduino.h>
+#include "software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+// A panel which can be unplugged.
+struct Unpluggable : I2cDevice {
+  Ssd1306Model &model;
+  bool plugged = true;
+  Unpluggable(Ssd1306Model &model) : model(model) {}
+  bool address(unsigned char sla) override {
+    return plugged && model.address(sla);
+  }
+  bool write(unsigned char byte) override {
+    return model.write(byte);
+  }
+  unsigned char read() override {
+    return model.read();
+  }
+  void stop() override {
+    model.stop();
+  }
+};
+
+static SoftwareI2c<20, 21, I2C_CALIBRATE, false, BusStats> i2c;
+static I2cBus bus(20, 21);
+static Ssd1306Model model;
+static Unpluggable panel(model);
+static Ssd1306<I2cTransport<decltype(i2c)>> ssd{i2c};
+static Display<128, 64> d;
+
+// Send the frame, check that the panel shows it and return the cycles it took.
+static unsigned long long frame() {
+  unsigned char image[1024];
+  unsigned long long cycles = host_gpio.cycles;
+  ssd.display(d.data());
+  cycles = host_gpio.cycles - cycles;
+  model.image(image);
+  CHECK(!memcmp(image, d.data(), sizeof(image)));
+  return cycles;
+}
+
+int main() {
+  static const unsigned RISE[] = {0, 20, 60, 150};
+  unsigned long long cycles, previous = 0, calibrated, slow;
+  unsigned char byte = 0;
+  bus.attach(&panel);
+  d.clear();
+  Awakening::text_centered(d, "Hier könnte Ihre", 0, 20, 128);
+  d.line(0, 0, 127, 63);
+
+  // Slower lines need a longer bit period, but the frame gets through.
+  for (unsigned i = 0; i < sizeof(RISE) / sizeof(*RISE); ++i) {
+    bus.rise_time(RISE[i]);
+    CHECK(ssd.init());
+    i2c.reset_stats();
+    cycles = frame();
+    CHECK(i2c.nacks == 0);
+    CHECK(cycles > previous);
+    previous = cycles;
+  }
+
+  bus.rise_time(0);
+  CHECK(ssd.init());
+  calibrated = frame();
+
+  // An address without a device does not slow the bus down.
+  for (int i = 0; i < 20; ++i) CHECK(!i2c.write(0x3d, &byte, 1));
+  CHECK(frame() == calibrated);
+
+  // Nor does a single failure of the panel.
+  panel.plugged = false;
+  CHECK(!i2c.write(0x3c, &byte, 1));
+  panel.plugged = true;
+  CHECK(frame() == calibrated);
+
+  // Repeated failures do.
+  panel.plugged = false;
+  for (int i = 0; i < 12; ++i) CHECK(!i2c.write(0x3c, &byte, 1));
+  panel.plugged = true;
+  slow = frame();
+  CHECK(slow > calibrated);
+
+  // A run of good transfers brings the period back.
+  for (int i = 0; i < 200; ++i) frame();
+  CHECK(frame() == calibrated);
+  return failures();
+}
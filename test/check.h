@@ -0,0 +1,28 @@
+#pragma once
+
+// The checks of the host tests. A test is a program which runs its checks and fails if
+// any of them failed, e.g.
+//
+//   int main() {
+//     CHECK(width("abc") == 17);
+//     return failures();
+//   }
+
+#include <stdio.h>
+
+inline int &check_failures() {
+  static int n = 0;
+  return n;
+}
+
+#define CHECK(condition) \
+  do { \
+    if (!(condition)) { \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      ++check_failures(); \
+    } \
+  } while (0)
+
+inline int failures() {
+  return check_failures() ? 1 : 0;
+}
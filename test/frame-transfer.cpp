@@ -0,0 +1,75 @@
+// Sends frames with `FrameTransfer` from a simulated timer interrupt, which fires between
+// the steps of drawing the next frame, and checks that the panel shows every frame whole.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "frame-transfer.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static SoftwareI2c<20, 21> i2c;
+static I2cBus bus(20, 21);
+static Ssd1306Model model;
+
+template<class Ssd, unsigned CHUNK>
+static void run(Ssd &ssd) {
+  static Display<128, 64, 2> d;
+  static FrameTransfer<Ssd, CHUNK> transfer{ssd};
+  unsigned char sent[1024], image[1024];
+  char digits[8];
+  bool pending = false;
+  int overlapped = 0, refused = 0;
+  // The timer interrupt. Once a frame is done the panel has to show it.
+  auto isr = [&] {
+    transfer.poll();
+    if (transfer.busy()) {
+      CHECK(!memcmp(d.front(), sent, sizeof(sent)));
+    } else if (pending) {
+      model.image(image);
+      CHECK(!memcmp(image, sent, sizeof(image)));
+      pending = false;
+    }
+  };
+  CHECK(ssd.init());
+  for (int n = 0; n < 20; ++n) {
+    // Draw the next frame in steps, with interrupts in between.
+    d.clear();
+    isr();
+    Awakening::text_centered(d, "Hier könnte Ihre", 0, 2, 128);
+    isr();
+    Awakening::text_centered(d, "Werbung stehen!", 0, 14, 128);
+    overlapped += transfer.busy();
+    isr();
+    snprintf(digits, sizeof(digits), "%d", 1769 + n);
+    Awakening::text_with_options(d, digits, 0, 40, 128, Awakening::CENTER | Awakening::TNUM);
+    isr();
+    d.invert(0, 0, n, 8);
+    while (!transfer.present(d)) {
+      ++refused;
+      isr();
+    }
+    memcpy(sent, d.front(), sizeof(sent));
+    pending = true;
+  }
+  while (pending) isr();
+  // Drawing went on while frames were sent, and `present` waited for them.
+  CHECK(overlapped > 0);
+  CHECK(refused > 0);
+  CHECK(bus.nacks == 0);
+}
+
+int main() {
+  static Ssd1306<I2cTransport<decltype(i2c)>> full{i2c};
+  static Ssd1306<I2cTransport<decltype(i2c)>, true> shadow{i2c};
+  bus.attach(&model);
+  run<decltype(full), 32>(full);
+  run<decltype(full), 16>(full);
+  run<decltype(shadow), 32>(shadow);
+  run<decltype(shadow), 128>(shadow);
+  return failures();
+}
@@ -0,0 +1,69 @@
+// Draws text in all options of the Awakening font and some primitives, and compares the
+// frame buffer with golden.pbm, which was rendered before the font moved to flash.
+//
+// Run `test-golden --write` in this directory to store the current picture instead,
+// after checking that a change of the rendering is intended.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "display.h"
+#include "awakening.h"
+#include "check.h"
+
+static Display<128, 64> d;
+
+static void draw() {
+  d.clear();
+  Awakening::text_centered(d, "Hier könnte Ihre", 0, 2, 128);
+  Awakening::text_centered(d, "Werbung stehen!", 0, 14, 128);
+  Awakening::text_centered(d, "Comment ça va?", 0, 26, 128);
+  Awakening::text_centered(d, "120kΩ 1769", 0, 40, 128);
+  Awakening::text_with_options(d, "ÀÉÎÕÜàéîöü ffß ÆŒ \e1\eud", -3, 52, 140, Awakening::LEFT);
+  Awakening::text_with_options(d, "1234-5.6 «»", 0, 60, 128, Awakening::RIGHT | Awakening::TNUM);
+  d.invert(100, 0, 128, 12);
+  d.fill_rect(0, 30, 8, 37, 1);
+  d.line(0, 0, 127, 63);
+}
+
+// Read a plain PBM of 128x64 pixels into the layout of a frame buffer.
+static bool read_pbm(const char *name, unsigned char *buffer) {
+  FILE *f = fopen(name, "r");
+  int w = 0, h = 0, c;
+  bool ok;
+  if (!f) return false;
+  ok = fscanf(f, "P1 %d %d", &w, &h) == 2 && w == 128 && h == 64;
+  memset(buffer, 0, 1024);
+  for (int i = 0; ok && i < w * h; ++i) {
+    while ((c = fgetc(f)) == ' ' || c == '\n');
+    if (c == '1') {
+      buffer[(i / w >> 3) * w + i % w] |= 1 << (i / w & 7);
+    } else if (c != '0') {
+      ok = false;
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+static void write_pbm(const char *name, const unsigned char *buffer) {
+  FILE *f = fopen(name, "w");
+  fprintf(f, "P1\n128 64\n");
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 128; ++x) fputc(buffer[(y >> 3) * 128 + x] >> (y & 7) & 1 ? '1' : '0', f);
+    fputc('\n', f);
+  }
+  fclose(f);
+}
+
+int main(int argc, char **argv) {
+  unsigned char golden[1024];
+  draw();
+  if (argc > 1 && !strcmp(argv[1], "--write")) {
+    write_pbm("golden.pbm", d.data());
+    return 0;
+  }
+  CHECK(read_pbm("golden.pbm", golden));
+  CHECK(!memcmp(d.data(), golden, sizeof(golden)));
+  return failures();
+}
@@ -0,0 +1,79 @@
+// Draws image.pbm converted by tools/image.py, raw and with RLE, at positions where it is
+// clipped on every side, and compares it with the pixels of the PBM.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "display.h"
+#include "image.h"
+#include "image-raw.h"
+#include "image-rle.h"
+#include "check.h"
+
+static bool pbm[64][64];
+static int pbm_width, pbm_height;
+
+// Read a plain PBM of at most 64x64 pixels.
+static bool read_pbm(const char *name) {
+  FILE *f = fopen(name, "r");
+  int c, i = 0;
+  if (!f) return false;
+  // The comment line of image.pbm is skipped with it.
+  if (fscanf(f, "P1 #%*[^\n] %d %d", &pbm_width, &pbm_height) != 2) {
+    fclose(f);
+    return false;
+  }
+  while (i < pbm_width * pbm_height && (c = fgetc(f)) != EOF) {
+    if (c == '0' || c == '1') {
+      pbm[i / pbm_width][i % pbm_width] = c == '1';
+      ++i;
+    }
+  }
+  fclose(f);
+  return i == pbm_width * pbm_height;
+}
+
+// The number of pixels which differ from the PBM at x, y on a display filled with `v`,
+// after drawing `image` there with `mode`.
+static unsigned wrong_pixels(const unsigned char *image, int x, int y, bool v, int mode) {
+  static Display<128, 64> d;
+  unsigned wrong = 0;
+  bool inside, p, lit;
+  d.clear(v);
+  Image::draw(d, image, x, y, mode);
+  for (int py = 0; py < 64; ++py) {
+    for (int px = 0; px < 128; ++px) {
+      lit = d.data()[(py >> 3) * 128 + px] >> (py & 7) & 1;
+      inside = px >= x && px < x + pbm_width && py >= y && py < y + pbm_height;
+      p = inside && pbm[py - y][px - x];
+      if (mode == Display<128, 64>::OR) p = v || p;
+      if (mode == Display<128, 64>::XOR) p = v != p;
+      if (mode == Display<128, 64>::AND) p = inside ? v && p : v;
+      if (lit != p) ++wrong;
+    }
+  }
+  return wrong;
+}
+
+int main() {
+  static const int POSITIONS[][2] = {
+    {0, 0}, {10, 3}, {83, 43}, {-10, -5}, {100, 50}, {120, -20}, {-44, 60}, {127, 63},
+    {-45, 0}, {50, -21}, {128, 10}, {40, 64},
+  };
+  const int OR = Display<128, 64>::OR, AND = Display<128, 64>::AND, XOR = Display<128, 64>::XOR;
+
+  CHECK(read_pbm("image.pbm"));
+  CHECK(Image::width(image_raw) == pbm_width && Image::height(image_raw) == pbm_height);
+  CHECK(Image::width(image_rle) == pbm_width && Image::height(image_rle) == pbm_height);
+  CHECK(!(flash_byte(image_raw + 2) & Image::RLE) && (flash_byte(image_rle + 2) & Image::RLE));
+  CHECK(sizeof(image_rle) < sizeof(image_raw));
+
+  for (auto &p : POSITIONS) {
+    CHECK(wrong_pixels(image_raw, p[0], p[1], false, OR) == 0);
+    CHECK(wrong_pixels(image_rle, p[0], p[1], false, OR) == 0);
+    CHECK(wrong_pixels(image_raw, p[0], p[1], true, AND) == 0);
+    CHECK(wrong_pixels(image_rle, p[0], p[1], true, AND) == 0);
+    CHECK(wrong_pixels(image_rle, p[0], p[1], true, XOR) == 0);
+  }
+  return failures();
+}
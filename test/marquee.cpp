@@ -0,0 +1,80 @@
+// Scrolls a tall picture through the panel with `Marquee`, checks every pixel of the
+// panel after every step and counts the bytes a step takes on the bus.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "marquee.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static SoftwareI2c<20, 21> i2c;
+static I2cBus bus(20, 21);
+static Ssd1306Model model;
+// The contents, repeated every 256 rows.
+static Display<128, 256> credits;
+
+static bool credits_pixel(int x, int y) {
+  y &= 255;
+  return credits.data()[(y >> 3) * 128 + x] >> (y & 7) & 1;
+}
+
+// The number of pixels of the panel which do not show the contents from row `top` on.
+static unsigned wrong_pixels(unsigned top) {
+  unsigned wrong = 0;
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 128; ++x) {
+      if (model.pixel(x, y) != credits_pixel(x, top + y)) ++wrong;
+    }
+  }
+  return wrong;
+}
+
+int main() {
+  static Ssd1306<I2cTransport<decltype(i2c)>, true> ssd{i2c};
+  static Marquee<decltype(ssd)> marquee{ssd};
+  static const char *const LINES[] = {
+    "Pferdetor", "Idee", "Kext", "Schrift", "Awakening", "Musik", "keine", "Dank an",
+    "alle Pferde", "und das Tor", "Ende", "", "Pferdetor", "1234567890", "Fin", "",
+  };
+  auto fill = [](unsigned char *band, unsigned n) {
+    memcpy(band, credits.data() + (n & 31) * 128, 128);
+  };
+  unsigned long bytes;
+  unsigned wrong = 0;
+  char text[8];
+  int steps = 300;
+
+  credits.clear();
+  for (int i = 0; i < 16; ++i) {
+    Awakening::text_centered(credits, LINES[i], 0, 16 * i + 2, 128);
+  }
+  for (int i = 0; i < 8; ++i) {
+    snprintf(text, sizeof(text), "%d", i);
+    Awakening::text(credits, text, 2 + 16 * i, 32 * i + 20, 12);
+  }
+  credits.line(0, 0, 127, 255);
+
+  bus.attach(&model);
+  CHECK(ssd.init());
+  CHECK(marquee.start(fill));
+  CHECK(wrong_pixels(0) == 0);
+  bytes = bus.bytes;
+  for (int i = 0; i < steps; ++i) {
+    CHECK(marquee.step(fill));
+    wrong += wrong_pixels(marquee.position());
+  }
+  bytes = bus.bytes - bytes;
+  printf("%d steps: %u wrong pixels, %lu bytes per step\n", steps, wrong, bytes / steps);
+  CHECK(marquee.position() == (unsigned) steps);
+  CHECK(wrong == 0);
+  // Only the columns where the row changes and the start line, instead of a frame of
+  // 1030 bytes or a whole row of 128 columns.
+  CHECK(bytes / steps < 100);
+  return failures();
+}
@@ -0,0 +1,82 @@
+// Drives two panels on one bus with `MultiPanel` and compares the bus time with sending
+// full frames to both panels one after the other.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "frame-transfer.h"
+#include "multi-panel.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static SoftwareI2c<20, 21> i2c;
+static I2cBus bus(20, 21);
+static Ssd1306Model left_model(0x3c), right_model(0x3d);
+
+static bool shows(const Ssd1306Model &model, const unsigned char *frame) {
+  unsigned char image[1024];
+  model.image(image);
+  return !memcmp(image, frame, sizeof(image));
+}
+
+static Display<128, 64> counter, label;
+
+// Frame f of both panels. The left one counts, the right one changes every fifth frame.
+static void draw(int f) {
+  char text[16];
+  counter.clear();
+  snprintf(text, sizeof(text), "%d", 1769 + 37 * f);
+  Awakening::text_with_options(counter, text, 0, 20, 128, Awakening::CENTER | Awakening::TNUM);
+  if (f == 0) {
+    label.clear();
+    Awakening::text_centered(label, "Pferdetor", 0, 20, 128);
+  }
+  if (f % 5 == 0) label.invert(0, 0, 128, 64);
+}
+
+int main() {
+  static Ssd1306<I2cTransport<decltype(i2c)>> full_left{i2c, 0x3c}, full_right{i2c, 0x3d};
+  static Ssd1306<I2cTransport<decltype(i2c)>, true> left{i2c, 0x3c}, right{i2c, 0x3d};
+  static FrameTransfer<decltype(left)> left_transfer{left}, right_transfer{right};
+  static MultiPanel<decltype(left_transfer), 2> panels{left_transfer, right_transfer};
+  unsigned long long sequential = 0, multi = 0, longest = 0, cycles, chunk;
+  bus.attach(&left_model);
+  bus.attach(&right_model);
+  CHECK(left.init() && right.init());
+
+  // Full frames to both panels, one after the other.
+  for (int f = 0; f < 20; ++f) {
+    draw(f);
+    cycles = bus.bus_cycles;
+    full_left.display(counter.data());
+    full_right.display(label.data());
+    sequential += bus.bus_cycles - cycles;
+    CHECK(shows(left_model, counter.data()) && shows(right_model, label.data()));
+  }
+
+  // Only changed panels and only the changed parts, in chunks.
+  for (int f = 0; f < 20; ++f) {
+    draw(f);
+    cycles = bus.bus_cycles;
+    panels.show(0, counter.data());
+    if (f % 5 == 0) panels.show(1, label.data());
+    while (panels.busy()) {
+      chunk = bus.bus_cycles;
+      panels.poll();
+      if (bus.bus_cycles - chunk > longest) longest = bus.bus_cycles - chunk;
+    }
+    multi += bus.bus_cycles - cycles;
+    CHECK(shows(left_model, counter.data()) && shows(right_model, label.data()));
+  }
+  printf("bus cycles per frame: sequential %llu, multi-panel %llu, longest poll %llu\n",
+         sequential / 20, multi / 20, longest);
+  CHECK(multi * 5 < sequential);
+  // No poll blocks for more than a quarter of a full frame.
+  CHECK(longest * 4 < sequential / 20 / 2);
+  CHECK(bus.nacks == 0);
+  return failures();
+}
@@ -0,0 +1,80 @@
+// Compares `NumberField` with the same number typeset right aligned with TNUM, and
+// checks that the area it returns covers all pixels which changed.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "display.h"
+#include "awakening.h"
+#include "number-field.h"
+#include "check.h"
+
+static Display<128, 64> d, expected, before;
+
+// If all pixels which differ between `before` and `d` are in `a`.
+template<class Area>
+static bool covers(const Area &a) {
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 128; ++x) {
+      bool changed = (before.data()[(y >> 3) * 128 + x] ^ d.data()[(y >> 3) * 128 + x]) >> (y & 7) & 1;
+      if (changed && (x < a.x1 || x >= a.x2 || y < a.y1 || y >= a.y2)) return false;
+    }
+  }
+  return true;
+}
+
+// Draw a minus centered in cell i of a field at x = 10.
+static void minus(Display<128, 64> &d, int i, int y) {
+  const unsigned char *glyph = Awakening::lookup_glyph("-");
+  Awakening::draw_glyph(d, glyph, 10 + 6 * i + (5 - Awakening::glyph_width(glyph)) / 2, y);
+}
+
+int main() {
+  static const long VALUES[] = {0, 7, 42, 1769, 1770, 1700, -5, -123, 99999, -9999, 12, 0};
+  static NumberField<5> field{10, 20};
+  static NumberField<5, 2> decimals{10, 40};
+  char text[16];
+  int n;
+  d.clear();
+  for (unsigned i = 0; i < sizeof(VALUES) / sizeof(*VALUES); ++i) {
+    long v = VALUES[i];
+    memcpy(&before, &d, sizeof(d));
+    auto a = field.show(d, v);
+    CHECK(covers(a));
+    CHECK(a.y1 == 20 && a.y2 == 20 + field.height());
+    CHECK(a.x1 >= 10 && a.x2 <= 10 + field.width());
+    // The digits are where TNUM would put them, the sign is centered in the cell before.
+    expected.clear();
+    n = snprintf(text, sizeof(text), "%ld", v < 0 ? -v : v);
+    Awakening::text_with_options(expected, text, 10, 20, field.width(), Awakening::RIGHT | Awakening::TNUM);
+    if (v < 0) minus(expected, 4 - n, 20);
+    CHECK(!memcmp(d.data(), expected.data(), 1024));
+  }
+
+  // The same value again changes nothing.
+  memcpy(&before, &d, sizeof(d));
+  auto a = field.show(d, 0);
+  CHECK(a.x1 == a.x2);
+  CHECK(!memcmp(before.data(), d.data(), 1024));
+
+  // Numbers which do not fit show dashes.
+  field.show(d, 123456);
+  expected.clear();
+  for (int i = 0; i < 5; ++i) minus(expected, i, 20);
+  CHECK(!memcmp(d.data(), expected.data(), 1024));
+
+  // With decimals the point goes between the cells.
+  d.clear();
+  decimals.invalidate();
+  for (unsigned i = 0; i < sizeof(VALUES) / sizeof(*VALUES); ++i) {
+    memcpy(&before, &d, sizeof(d));
+    auto b = decimals.show(d, VALUES[i]);
+    CHECK(covers(b));
+    CHECK(b.x1 >= 10 && b.x2 <= 10 + decimals.width());
+  }
+  memcpy(&before, &d, sizeof(d));
+  decimals.show(d, 1234);
+  expected.clear();
+  Awakening::text_with_options(expected, "12.34", 10, 40, decimals.width(), Awakening::RIGHT | Awakening::TNUM);
+  CHECK(!memcmp(d.data(), expected.data(), 1024));
+  return failures();
+}
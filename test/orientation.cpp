@@ -0,0 +1,75 @@
+// Draws the same picture in all eight orientations and checks that the panel shows it
+// turned clockwise by the angle, and flipped left to right before that with MIRROR.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static SoftwareI2c<20, 21> i2c;
+static I2cBus bus(20, 21);
+static Ssd1306Model model;
+
+// Something which looks different in every orientation.
+template<class Display>
+static void draw(Display &d) {
+  d.clear();
+  Awakening::text(d, "Pferdetor", 2, 2, d.width() - 4);
+  d.line(0, 0, d.width() - 1, d.height() / 2);
+  d.rect(d.width() - 12, d.height() - 20, d.width() - 2, d.height() - 2);
+  d.pixel(0, d.height() - 1);
+}
+
+// Where the pixel at x, y of a picture of w x h pixels is shown on the panel.
+static void panel_position(int orientation, int w, int h, int x, int y, int &px, int &py) {
+  if (orientation & MIRROR) x = w - 1 - x;
+  switch (orientation & 3) {
+    case ROTATE_0: px = x; py = y; break;
+    case ROTATE_90: px = h - 1 - y; py = x; break;
+    case ROTATE_180: px = w - 1 - x; py = h - 1 - y; break;
+    case ROTATE_270: px = y; py = w - 1 - x; break;
+  }
+}
+
+// The number of pixels which the panel shows wrong.
+template<int orientation>
+static unsigned wrong_pixels() {
+  static constexpr int W = orientation & 1 ? 64 : 128, H = orientation & 1 ? 128 : 64;
+  static Ssd1306<I2cTransport<decltype(i2c)>, false, orientation> ssd{i2c};
+  static Display<W, H, 1, orientation> d;
+  static Display<W, H> picture;
+  unsigned wrong = 0;
+  int px, py;
+  bool lit;
+  CHECK(ssd.init());
+  draw(d);
+  draw(picture);
+  ssd.display(d.data());
+  for (int y = 0; y < H; ++y) {
+    for (int x = 0; x < W; ++x) {
+      lit = picture.data()[(y >> 3) * W + x] >> (y & 7) & 1;
+      panel_position(orientation, W, H, x, y, px, py);
+      if (model.pixel(px, py) != lit) ++wrong;
+    }
+  }
+  printf("orientation %d: %u wrong pixels\n", orientation, wrong);
+  return wrong;
+}
+
+int main() {
+  bus.attach(&model);
+  CHECK(wrong_pixels<ROTATE_0>() == 0);
+  CHECK(wrong_pixels<ROTATE_90>() == 0);
+  CHECK(wrong_pixels<ROTATE_180>() == 0);
+  CHECK(wrong_pixels<ROTATE_270>() == 0);
+  CHECK(wrong_pixels<MIRROR | ROTATE_0>() == 0);
+  CHECK(wrong_pixels<MIRROR | ROTATE_90>() == 0);
+  CHECK(wrong_pixels<MIRROR | ROTATE_180>() == 0);
+  CHECK(wrong_pixels<MIRROR | ROTATE_270>() == 0);
+  return failures();
+}
@@ -0,0 +1,113 @@
+// Wraps texts with `Paragraph` and compares the lines with breaking every line again
+// from its start, for line feeds, words longer than a line and too many lines.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "display.h"
+#include "awakening.h"
+#include "paragraph.h"
+#include "check.h"
+
+static const char *const TEXTS[] = {
+  "Das Tor schliesst in 12 Minuten.\nBitte warten.",
+  "Pferdetor 1234 5678 ab 9 Uhr 10",
+  "Ein Wort: Donaudampfschifffahrt",
+  "  Zwei   Leerzeichen  ",
+  "eins\n\nzwei\n",
+  "",
+};
+
+static int measure(const char *s, const char *e, int options) {
+  return Awakening::width(s, e, options & Awakening::TNUM);
+}
+
+// The end of the line starting at `s`, measuring the whole line for every word.
+static const char *reference_end(const char *s, int w, int options) {
+  const char *p = s, *q, *brk = s;
+  while (true) {
+    for (q = p; *q && *q != ' ' && *q != '\n'; ++q);
+    if (q > p && measure(s, q, options) > w) break;
+    brk = q;
+    for (p = q; *p == ' '; ++p);
+    if (!*p || *p == '\n') break;
+  }
+  if (brk > s) return brk;
+  for (p = s; *p == ' '; ++p);
+  if (!*p || *p == '\n') return p;
+  for (brk = p + 1, q = brk; *q && *q != ' ' && *q != '\n'; brk = q) {
+    ++q;
+    if (measure(s, q, options) > w) break;
+  }
+  return brk;
+}
+
+// If every line of `p` ends where `reference_end` ends it.
+template<unsigned N>
+static bool same_lines(const Paragraph<N> &p, const char *text, int w, int options) {
+  const char *s = text, *e;
+  for (unsigned i = 0; i < p.lines(); ++i) {
+    if (p.start(i) != s) return false;
+    e = *s == '\n' ? s : reference_end(s, w, options);
+    if (p.end(i) != e || p.width(i) != measure(s, e, options)) return false;
+    s = e;
+    if (*s == '\n') {
+      ++s;
+    } else {
+      while (*s == ' ') ++s;
+      if (*s == '\n') ++s;
+    }
+  }
+  return !*s;
+}
+
+int main() {
+  static Display<128, 64> d;
+  Paragraph<64> p;
+  Paragraph<2> short_paragraph;
+  const char *text;
+
+  // Nothing laid out yet draws nothing.
+  d.clear();
+  CHECK(p.lines() == 0);
+  CHECK(p.draw(d, 0, 0, 64) == 0);
+
+  for (const char *t : TEXTS) {
+    for (int w = 1; w <= 128; ++w) {
+      CHECK(p.layout(t, w));
+      CHECK(same_lines(p, t, w, Awakening::LEFT));
+      CHECK(p.layout(t, w, Awakening::TNUM));
+      CHECK(same_lines(p, t, w, Awakening::TNUM));
+    }
+  }
+
+  // Line feeds end a line, two of them give an empty line.
+  text = "eins\n\nzwei\n";
+  CHECK(p.layout(text, 128));
+  CHECK(p.lines() == 3);
+  CHECK(p.end(0) - p.start(0) == 4 && !strncmp(p.start(0), "eins", 4));
+  CHECK(p.end(1) == p.start(1) && p.width(1) == 0);
+  CHECK(p.end(2) - p.start(2) == 4 && !strncmp(p.start(2), "zwei", 4));
+
+  // A word longer than the line is broken where it has to, each part as long as fits.
+  text = "Donaudampfschifffahrt";
+  int w = measure(text, text + 5, 0);
+  CHECK(p.layout(text, w));
+  CHECK(p.lines() > 1);
+  for (unsigned i = 0; i < p.lines(); ++i) {
+    CHECK(p.width(i) <= w);
+    CHECK(i + 1 == p.lines() || measure(p.start(i), p.end(i) + 1, 0) > w);
+    CHECK(i + 1 == p.lines() || p.end(i) == p.start(i + 1));
+  }
+  CHECK(*p.end(p.lines() - 1) == 0);
+
+  // More lines than MAX_LINES keeps the first ones and says so, also when unchanged.
+  text = "a\nb\nc";
+  CHECK(!short_paragraph.layout(text, 128));
+  CHECK(short_paragraph.lines() == 2);
+  CHECK(*short_paragraph.start(1) == 'b' && short_paragraph.end(1) == short_paragraph.start(1) + 1);
+  CHECK(!short_paragraph.layout(text, 128));
+  CHECK(short_paragraph.layout("a b c", 128));
+  CHECK(short_paragraph.lines() == 1);
+  return failures();
+}
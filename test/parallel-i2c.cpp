@@ -0,0 +1,69 @@
+// Sends three different frames to three panels on their own SDA lines with a shared SCL
+// through `ParallelSoftwareI2c`, and compares the time with one frame on one bus.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "software-i2c.h"
+#include "parallel-software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static ParallelSoftwareI2c<21, 16, 22, 23, 24> parallel;
+static SoftwareI2c<20, 21> single;
+static I2cBus bus1(22, 21), bus2(23, 21), bus3(24, 21), single_bus(20, 21);
+static I2cBus *const buses[] = {&bus1, &bus2, &bus3};
+static Ssd1306Model models[3], single_model;
+// Panels at 0x3d on the first two buses only.
+static Ssd1306Model others[2] = {Ssd1306Model(0x3d), Ssd1306Model(0x3d)};
+static Display<128, 64> frames[3];
+
+int main() {
+  static Ssd1306<I2cTransport<decltype(parallel)>> panels{parallel};
+  static Ssd1306<I2cTransport<decltype(single)>> panel{single};
+  const unsigned char *data[3];
+  unsigned char image[1024];
+  unsigned long long cycles, one, three;
+  char text[16];
+  for (int i = 0; i < 3; ++i) {
+    buses[i]->attach(&models[i]);
+    frames[i].clear();
+    snprintf(text, sizeof(text), "Panel %d", i + 1);
+    Awakening::text_centered(frames[i], text, 0, 20, 128);
+    frames[i].line(0, 0, 127, 63 - 20 * i);
+    data[i] = frames[i].data();
+  }
+  single_bus.attach(&single_model);
+
+  CHECK(panel.init());
+  cycles = host_gpio.cycles;
+  panel.display(frames[0].data());
+  one = host_gpio.cycles - cycles;
+  single_model.image(image);
+  CHECK(!memcmp(image, frames[0].data(), sizeof(image)));
+
+  // Every panel gets its own frame in about the time of one.
+  CHECK(panels.init());
+  cycles = host_gpio.cycles;
+  CHECK(panels.display_each(data));
+  three = host_gpio.cycles - cycles;
+  for (int i = 0; i < 3; ++i) {
+    models[i].image(image);
+    CHECK(!memcmp(image, frames[i].data(), sizeof(image)));
+    CHECK(buses[i]->nacks == 0);
+  }
+  printf("cycles per frame: one bus %llu, three buses %llu\n", one, three);
+  CHECK(three < one * 11 / 10);
+
+  // Without a device on the last bus only the others acknowledge.
+  bus1.attach(&others[0]);
+  bus2.attach(&others[1]);
+  CHECK(parallel.write_command_each(0x3d, 0x40, data, 4) == 3);
+  CHECK(!parallel.write(0x3d, data[0], 4));
+  CHECK(parallel.write_command_each(0x3e, 0x40, data, 4) == 0);
+  CHECK(parallel.write(0x3c, data[0], 4));
+  return failures();
+}
@@ -0,0 +1,79 @@
+// Counts the bytes on the bus for typical frames with and without the shadow copy, and
+// checks that the panel shows every frame.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static SoftwareI2c<20, 21> i2c;
+static I2cBus bus(20, 21);
+static Ssd1306Model model;
+static Display<128, 64> d;
+
+static void draw(int n) {
+  char digits[8];
+  d.clear();
+  Awakening::text_centered(d, "Hier könnte Ihre", 0, 2, 128);
+  Awakening::text_centered(d, "Werbung stehen!", 0, 14, 128);
+  snprintf(digits, sizeof(digits), "%d", n);
+  Awakening::text_with_options(d, digits, 0, 40, 128, Awakening::CENTER | Awakening::TNUM);
+}
+
+// Send the current frame and return the bytes it took on the bus.
+template<class Ssd>
+static unsigned long send(Ssd &ssd) {
+  unsigned char image[1024];
+  unsigned long bytes = bus.bytes;
+  ssd.display(d.data());
+  model.image(image);
+  CHECK(!memcmp(image, d.data(), sizeof(image)));
+  return bus.bytes - bytes;
+}
+
+int main() {
+  static Ssd1306<I2cTransport<decltype(i2c)>> full{i2c};
+  static Ssd1306<I2cTransport<decltype(i2c)>, true> shadow{i2c};
+  unsigned long frame, bytes;
+  bus.attach(&model);
+  CHECK(shadow.init());
+
+  // Without the shadow copy every frame is the whole display RAM.
+  draw(1769);
+  frame = send(full);
+  CHECK(frame > 1024);
+  CHECK(send(full) == frame);
+
+  // The first frame is sent completely, an unchanged one not at all.
+  CHECK(send(shadow) == frame);
+  CHECK(send(shadow) == 0);
+
+  // A changed number costs a fraction of the frame.
+  for (int n = 1770; n < 1800; ++n) {
+    draw(n);
+    bytes = send(shadow);
+    CHECK(bytes > 0);
+    CHECK(bytes * 10 < frame);
+  }
+
+  // A single pixel is one window and one data byte.
+  d.pixel(127, 63);
+  CHECK(send(shadow) == 8 + 3);
+
+  // After `invalidate` the next frame is sent completely again.
+  shadow.invalidate();
+  CHECK(send(shadow) == frame);
+
+  // A copy takes over the shadow copy, not the copy as arguments of the transport.
+  Ssd1306<I2cTransport<decltype(i2c)>, true> copy(shadow);
+  CHECK(send(copy) == 0);
+  d.pixel(0, 0);
+  CHECK(send(copy) == 8 + 3);
+  CHECK(bus.nacks == 0);
+  return failures();
+}
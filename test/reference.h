@@ -0,0 +1,81 @@
+#pragma once
+
+// A display of W x H pixels which draws everything pixel by pixel, the plain way.
+// The shapes use the same algorithms as on `Display`, but drawn from these
+// primitives, so the two have to give the same picture.
+
+#include <string.h>
+#include "shapes.h"
+
+template<int W, int H>
+class Reference : public Shapes<Reference<W, H>> {
+    bool pixels[H][W];
+    static void order(int &a, int &b) {
+      int t;
+      if (b < a) {
+        t = b; b = a; a = t;
+      }
+    }
+    // Apply `op` to all pixels between x1, y1 and x2, y2 (exclusive).
+    template<class Op>
+    void area(int x1, int y1, int x2, int y2, Op op) {
+      order(x1, x2);
+      order(y1, y2);
+      for (int y = y1; y < y2; ++y) {
+        for (int x = x1; x < x2; ++x) {
+          if (x >= 0 && x < W && y >= 0 && y < H) pixels[y][x] = op(pixels[y][x]);
+        }
+      }
+    }
+  public:
+    using Shapes<Reference>::OR;
+    using Shapes<Reference>::AND;
+    using Shapes<Reference>::XOR;
+    unsigned width() const {
+      return W;
+    }
+    bool get(int x, int y) const {
+      return pixels[y][x];
+    }
+    void clear(bool v = false) {
+      memset(pixels, v, sizeof(pixels));
+    }
+    void pixel(int x, int y, bool v = true) {
+      if (x >= 0 && x < W && y >= 0 && y < H) pixels[y][x] = v;
+    }
+    void invert(int x1, int y1, int x2, int y2) {
+      area(x1, y1, x2, y2, [](bool p) { return !p; });
+    }
+    void fill_rect(int x1, int y1, int x2, int y2, int v) {
+      area(x1, y1, x2, y2, [v](bool) { return v != 0; });
+    }
+    void hline(int x1, int x2, int y, bool v = true) {
+      order(x1, x2);
+      for (int x = x1; x <= x2; ++x) pixel(x, y, v);
+    }
+    void vline(int x, int y1, int y2, bool v = true) {
+      order(y1, y2);
+      for (int y = y1; y <= y2; ++y) pixel(x, y, v);
+    }
+    void blit_column(int x, int y, unsigned bits, int mode = OR, int height = 16) {
+      for (int i = 0; i < height; ++i) {
+        if (x < 0 || x >= W || y + i < 0 || y + i >= H) continue;
+        if (mode == OR && bits >> i & 1) pixels[y + i][x] = true;
+        if (mode == XOR && bits >> i & 1) pixels[y + i][x] = !pixels[y + i][x];
+        if (mode == AND && !(bits >> i & 1)) pixels[y + i][x] = false;
+      }
+    }
+    // Bresenham's algorithm for every line, also horizontal and vertical ones.
+    void line(int x1, int y1, int x2, int y2) {
+      int dx = x2 > x1 ? x2 - x1 : x1 - x2, sx = x1 < x2 ? 1 : -1;
+      int dy = y2 > y1 ? y2 - y1 : y1 - y2, sy = y1 < y2 ? 1 : -1;
+      int err = (dx > dy ? dx : -dy) / 2, e2;
+      while (true) {
+        pixel(x1, y1);
+        if (x1 == x2 && y1 == y2) break;
+        e2 = err;
+        if (e2 > -dx) { err -= dy; x1 += sx; }
+        if (e2 < dy) { err += dx; y1 += sy; }
+      }
+    }
+};
@@ -0,0 +1,114 @@
+// Compares the primitives and shapes of `Display` with a `Reference` which draws them
+// pixel by pixel, for random arguments in and around the display, and checks the
+// geometry of circles.
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include "display.h"
+#include "reference.h"
+#include "check.h"
+
+static int random_in(int lo, int hi) {
+  return lo + rand() % (hi - lo + 1);
+}
+
+// Draw operation `op` with the arguments `a`.
+template<class D>
+static void draw(D &d, int op, const int *a) {
+  switch (op) {
+  case 0: d.fill_rect(a[0], a[1], a[2], a[3], a[4] & 1); break;
+  case 1: d.invert(a[0], a[1], a[2], a[3]); break;
+  case 2: d.hline(a[0], a[2], a[1], a[4] & 1); break;
+  case 3: d.vline(a[0], a[1], a[3], a[4] & 1); break;
+  case 4: d.line(a[0], a[1], a[2], a[3]); break;
+  case 5: d.rect(a[0], a[1], a[2], a[3], a[4] & 1); break;
+  case 6: d.round_rect(a[0], a[1], a[2], a[3], a[5], a[4] & 1); break;
+  case 7: d.fill_round_rect(a[0], a[1], a[2], a[3], a[5], a[4] & 1); break;
+  case 8: d.circle(a[0], a[1], a[5], a[4] & 1); break;
+  case 9: d.fill_circle(a[0], a[1], a[5], a[4] & 1); break;
+  case 10: d.blit_column(a[0], a[1], a[6] & ((1 << a[7]) - 1), a[4] % 3, a[7]); break;
+  default: d.pixel(a[0], a[1], a[4] & 1); break;
+  }
+}
+
+// If pixel x, y is lit in the frame buffer of `d`.
+template<unsigned W, unsigned H, int orientation>
+static bool lit(const Display<W, H, 1, orientation> &d, int x, int y) {
+  if (orientation & 1) return d.data()[(x >> 3) * H + y] >> (x & 7) & 1;
+  return d.data()[(y >> 3) * W + x] >> (y & 7) & 1;
+}
+
+template<int W, int H, class D>
+static bool same(const D &d, const Reference<W, H> &r) {
+  for (int y = 0; y < H; ++y) {
+    for (int x = 0; x < W; ++x) {
+      if (lit(d, x, y) != r.get(x, y)) return false;
+    }
+  }
+  return true;
+}
+
+template<int W, int H, int orientation>
+static void compare() {
+  static Display<W, H, 1, orientation> d;
+  static Reference<W, H> r;
+  int a[8], op;
+  d.clear();
+  r.clear();
+  for (int i = 0; i < 20000; ++i) {
+    op = i % 12;
+    a[0] = random_in(-20, W + 20);
+    a[1] = random_in(-20, H + 20);
+    a[2] = random_in(-20, W + 20);
+    a[3] = random_in(-20, H + 20);
+    // Also areas which end at page boundaries and at the edges.
+    if (i % 5 == 0) a[3] = a[3] & ~7;
+    if (i % 7 == 0) a[3] = H;
+    a[4] = rand();
+    a[5] = random_in(-2, 40);
+    a[6] = rand();
+    a[7] = random_in(1, 16);
+    draw(d, op, a);
+    draw(r, op, a);
+    if (!same(d, r)) {
+      fprintf(stderr, "operation %d: %d %d %d %d %d %d\n", op, a[0], a[1], a[2], a[3], a[4] & 1, a[5]);
+      CHECK(same(d, r));
+      return;
+    }
+  }
+}
+
+// Circles have their outline at the radius and are filled up to it.
+static void circles() {
+  static Display<128, 64> outline, disc;
+  int dx, dy, d2;
+  for (int r = 0; r < 30; ++r) {
+    outline.clear();
+    disc.clear();
+    outline.circle(64, 32, r);
+    disc.fill_circle(64, 32, r);
+    for (int y = 0; y < 64; ++y) {
+      for (int x = 0; x < 128; ++x) {
+        dx = x - 64;
+        dy = y - 32;
+        d2 = dx * dx + dy * dy;
+        if (lit(outline, x, y)) {
+          CHECK(lit(disc, x, y));
+          CHECK(lit(outline, 128 - x, y) && lit(outline, x, 64 - y));
+          CHECK((!r || (r - 0.75) * (r - 0.75) <= d2) && d2 <= (r + 0.75) * (r + 0.75));
+        }
+        if (r > 0 && d2 <= (r - 1) * (r - 1)) CHECK(lit(disc, x, y));
+        if (d2 > (r + 1) * (r + 1)) CHECK(!lit(disc, x, y));
+      }
+    }
+  }
+}
+
+int main() {
+  srand(1);
+  compare<128, 64, ROTATE_0>();
+  compare<64, 128, ROTATE_90>();
+  compare<128, 32, ROTATE_0>();
+  circles();
+  return failures();
+}
@@ -0,0 +1,27 @@
+// Runs the sketch against a simulated panel and checks what it shows.
+
+#include <Arduino.h>
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+#include "Pferdetor.ino"
+
+int main() {
+  static I2cBus bus(20, 21);
+  static Ssd1306Model model;
+  static Display<128, 64> expected;
+  unsigned char image[1024];
+  bus.attach(&model);
+  setup();
+  for (int i = 0; i < 10; ++i) loop();
+  expected.clear();
+  Awakening::text_centered(expected, "Hier könnte Ihre", 0, 2, 128);
+  Awakening::text_centered(expected, "Werbung stehen!", 0, 14, 128);
+  Awakening::text_centered(expected, "Comment ça va?", 0, 26, 128);
+  Awakening::text_centered(expected, "120kΩ 1769", 0, 40, 128);
+  model.image(image);
+  CHECK(!memcmp(image, expected.data(), sizeof(image)));
+  CHECK(bus.nacks == 0);
+  CHECK(model.on);
+  return failures();
+}
@@ -0,0 +1,80 @@
+// Sends frames over the SPI transports to simulated 4-wire panels and checks the display
+// RAM, the bytes on the bus and how often D/C switched.
+
+#include <Arduino.h>
+#include "spi-transport.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "awakening.h"
+#include "spi-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static Display<128, 64> d;
+
+// The bytes of the init sequence of `Ssd1306`.
+static const unsigned long INIT = 32;
+
+template<class Ssd, class Panel>
+static void check_panel(Ssd &ssd, Panel &panel, Ssd1306Model &model) {
+  unsigned long bytes, switches;
+  d.clear();
+  Awakening::text_centered(d, "Hier könnte Ihre", 0, 20, 128);
+  d.line(0, 0, 127, 63);
+  CHECK(ssd.init());
+  CHECK(panel.bytes == INIT);
+  CHECK(panel.switches == 0);
+  CHECK(model.on);
+
+  // A frame is a window command and the data, with a switch of D/C for the data.
+  ssd.display(d.data());
+  CHECK(!memcmp(model.ram, d.data(), sizeof(model.ram)));
+  CHECK(panel.bytes == INIT + 6 + 1024);
+  CHECK(panel.switches == 1);
+  CHECK(panel.run == 1024);
+
+  // Back to commands for the next frame.
+  d.invert(0, 0, 128, 64);
+  bytes = panel.bytes;
+  switches = panel.switches;
+  ssd.display(d.data());
+  CHECK(!memcmp(model.ram, d.data(), sizeof(model.ram)));
+  if (Ssd::SHADOW) {
+    // Every page changed, so every page is a window and a run of data.
+    CHECK(panel.switches == switches + 16);
+    CHECK(panel.bytes == bytes + 8 * (6 + 128));
+    // A changed pixel is a window and one byte.
+    d.pixel(5, 60, false);
+    bytes = panel.bytes;
+    ssd.display(d.data());
+    CHECK(!memcmp(model.ram, d.data(), sizeof(model.ram)));
+    CHECK(panel.bytes == bytes + 6 + 1);
+    CHECK(panel.run == 1);
+  } else {
+    CHECK(panel.switches == switches + 2);
+    CHECK(panel.bytes == bytes + 6 + 1024);
+  }
+}
+
+int main() {
+  // The SPI peripheral, with D/C on 8 and CS on 9.
+  {
+    static Ssd1306Model model;
+    static SpiPanel<Ssd1306Model> panel(model, 8, 9);
+    static Ssd1306<HardwareSpi<8, 9, 10>> ssd;
+    host_spi.device = &panel;
+    check_panel(ssd, panel, model);
+    CHECK(host_spi.bytes == panel.bytes);
+  }
+  // Bit-banged on 22 and 23, with D/C on 24 and CS on 25.
+  {
+    static Ssd1306Model model;
+    static SpiPanel<Ssd1306Model> panel(model, 24, 25);
+    static SpiBus bus(22, 23, 25);
+    static Ssd1306<SoftwareSpi<22, 23, 24, 25>, true> ssd;
+    bus.attach(&panel);
+    check_panel(ssd, panel, model);
+    CHECK(bus.bytes == panel.bytes);
+  }
+  return failures();
+}
@@ -0,0 +1,60 @@
+// Draws text in a font compiled by `fontc.py --stream` from a file, with the default cache
+// and with one too small for the glyphs, and checks that both draw the same and how
+// often they found the glyphs in the cache.
+//
+//   test-stream-font awakening.sf
+
+#include <Arduino.h>
+#include "display.h"
+#include "stream-font.h"
+#include "file-storage.h"
+#include "check.h"
+
+static Display<128, 64> cached_display, uncached_display;
+
+template<class Font>
+static void draw(Font &font, Display<128, 64> &d) {
+  d.clear();
+  font.text(d, "Hier könnte Ihre", 0, 0);
+  font.text_with_options(d, "120kΩ 1769", 0, 16, 128, Font::CENTER);
+  font.text_with_options(d, "Comment ça va?", 0, 32, 128, Font::RIGHT);
+  // U+2603 is not in the font, the replacement character is missing as well.
+  font.text(d, "\xe2\x98\x83 -3", -2, 50);
+}
+
+int main(int argc, char **argv) {
+  CHECK(argc == 2);
+  if (argc != 2) return failures();
+  FileStorage storage(argv[1]);
+  StreamFont<FileStorage> cached(storage);
+  StreamFont<FileStorage, 2, 4> uncached(storage);
+  CHECK(cached.begin() && uncached.begin());
+  CHECK(cached.height() == 16);
+
+  draw(cached, cached_display);
+  draw(uncached, uncached_display);
+  CHECK(!memcmp(cached_display.data(), uncached_display.data(), 1024));
+  // Something was drawn in every line.
+  for (int page = 0; page < 8; page += 2) {
+    int lit = 0;
+    for (int i = 0; i < 256; ++i) lit += cached_display.data()[page * 128 + i] != 0;
+    CHECK(lit > 0);
+  }
+
+  // `begin` empties the cache. Measuring and drawing look a glyph up twice, so a
+  // cached one is found the second time. No glyph fits into four bytes, so the small cache never has one.
+  CHECK(cached.begin());
+  cached.hits = cached.misses = uncached.hits = uncached.misses = 0;
+  cached.text(cached_display, "abba", 0, 0);
+  uncached.text(uncached_display, "abba", 0, 0);
+  CHECK(cached.misses == 2 && cached.hits == 6);
+  CHECK(uncached.misses == 8 && uncached.hits == 0);
+  cached.text(cached_display, "abba", 0, 0);
+  CHECK(cached.misses == 2 && cached.hits == 14);
+
+  // A missing font is no font.
+  FileStorage missing("missing.sf");
+  StreamFont<FileStorage> none(missing);
+  CHECK(!none.begin());
+  return failures();
+}
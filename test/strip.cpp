@@ -0,0 +1,81 @@
+// Renders frames page by page with `Strip` and compares what the panel shows with the
+// same frames drawn into a full `Display`.
+
+#include <Arduino.h>
+#include "software-i2c.h"
+#include "ssd1306.h"
+#include "display.h"
+#include "strip.h"
+#include "display-list.h"
+#include "i2c-bus.h"
+#include "ssd1306-model.h"
+#include "check.h"
+
+static SoftwareI2c<20, 21> i2c;
+static I2cBus bus(20, 21);
+static Ssd1306Model model;
+static Ssd1306<I2cTransport<decltype(i2c)>> ssd{i2c};
+static Display<128, 64> d;
+static Strip<128, 64> strip;
+
+// Check that the panel shows the full frame buffer.
+static bool shows_display() {
+  unsigned char image[1024];
+  model.image(image);
+  return !memcmp(image, d.data(), sizeof(image));
+}
+
+// Draw operations a list does not record, the same for both kinds of display.
+template<class D>
+static void shapes(D &d) {
+  d.rect(-5, 3, 40, 70);
+  d.round_rect(30, 10, 90, 50, 8);
+  d.fill_round_rect(100, -4, 140, 20, 6);
+  d.circle(64, 32, 30);
+  d.fill_circle(10, 60, 12);
+  d.hline(-10, 200, 31);
+  d.vline(127, -3, 66);
+  d.pixel(0, 63);
+  d.blit_column(126, 58, 0xffff);
+}
+
+int main() {
+  DisplayList<32> list;
+  bus.attach(&model);
+  CHECK(ssd.init());
+
+  list.text("Hier könnte Ihre", 0, 2, 128, Awakening::CENTER);
+  list.text("Werbung stehen!", 0, 14, 128, Awakening::CENTER);
+  list.text("Comment ça va?", 0, 26, 128, Awakening::CENTER);
+  list.text("120kΩ 1769", 0, 40, 128, Awakening::CENTER | Awakening::TNUM);
+  list.text("ÀÉÎÕÜàéîöü ffß ÆŒ", -3, 52, 140);
+  list.text("1234-5.6 «»", 0, 60, 128, Awakening::RIGHT | Awakening::TNUM);
+  list.text("above", 10, -10, 128);
+  list.invert(100, 0, 128, 12);
+  list.fill_rect(0, 30, 8, 37, 1);
+  list.fill_rect(20, 3, 30, 20, 0);
+  list.invert(50, 60, 70, 70);
+  list.line(0, 0, 127, 63);
+  list.line(127, 0, 0, 63);
+  list.line(10, -5, 200, 30);
+
+  // Replaying a list, on black and on white.
+  for (int v = 0; v < 2; ++v) {
+    d.clear(v);
+    list.replay(d);
+    CHECK(strip.render(ssd, list, v));
+    CHECK(shows_display());
+  }
+
+  // Drawing the shapes again for every page.
+  d.clear();
+  shapes(d);
+  for (int p = 0; p < 8; ++p) {
+    strip.begin(p);
+    shapes(strip);
+    CHECK(ssd.window(0, 127, p, p) && ssd.write(strip.data(), 128));
+  }
+  CHECK(shows_display());
+  CHECK(bus.nacks == 0);
+  return failures();
+}
@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+"""Compile a BDF or PNG font into glyphs for awakening.h or a font for stream-font.h.
+
+Glyphs are placed in a line of 16 pixels, or --height for stream fonts. The glyphs of the
+built-in font have their baseline at row 10, so their 8 pixel high part covers rows 4 to 11.
+
+    tools/fontc.py font.bdf > glyphs.inc
+    tools/fontc.py sheet.png --cell 6x8 --chars 'ABC...' > glyphs.inc
+    tools/fontc.py font.bdf --height 24 --baseline 19 --stream font.sf
+    tools/fontc.py awakening.h --compact > glyphs.inc
+    tools/fontc.py awakening.h --index > index.inc
+
+The output for awakening.h are the lines of its GLYPHS table. With --compact glyphs whose
+pixels fit into 8 rows anywhere in the line get one byte per column. An awakening.h as
+input reads its table, to encode it again.
+
+With --index the output are the lines of the INDEX table instead, the offsets of the glyphs
+sorted by their text. For an awakening.h these are the offsets in its table as it is.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+
+def read_bdf(f, baseline):
+    glyphs = []
+    codepoint = None
+    bitmap = None
+    for line in f:
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == 'ENCODING':
+            codepoint = int(words[1])
+        elif words[0] == 'BBX':
+            w, h, xoff, yoff = (int(v) for v in words[1:5])
+        elif words[0] == 'BITMAP':
+            bitmap = []
+        elif words[0] == 'ENDCHAR':
+            if codepoint is not None and codepoint > 32:
+                columns = [0] * w
+                for j, row in enumerate(bitmap):
+                    y = baseline - yoff - h + j
+                    bits = int(row, 16) if row else 0
+                    for x in range(w):
+                        if bits >> (len(row) * 4 - 1 - x) & 1:
+                            if y < 0:
+                                sys.exit('glyph %d is above the line, raise --baseline' % codepoint)
+                            columns[x] |= 1 << y
+                glyphs.append((chr(codepoint).encode('utf-8'), columns))
+            codepoint = None
+            bitmap = None
+        elif bitmap is not None:
+            bitmap.append(words[0])
+    return glyphs
+
+
+def read_png(name, cell, chars, top, invert):
+    from PIL import Image
+    image = Image.open(name).convert('LA')
+    pixels = image.load()
+    cw, ch = cell
+    per_row = image.size[0] // cw
+    glyphs = []
+    for i, c in enumerate(chars):
+        if c == ' ':
+            continue
+        x0, y0 = i % per_row * cw, i // per_row * ch
+        columns = []
+        for x in range(cw):
+            bits = 0
+            for y in range(ch):
+                level, alpha = pixels[x0 + x, y0 + y]
+                if alpha >= 128 and (level >= 128 if invert else level < 128):
+                    bits |= 1 << (top + y)
+            columns.append(bits)
+        glyphs.append((c.encode('utf-8'), columns))
+    return glyphs
+
+
+def read_table(f):
+    source = f.read()
+    start = source.index('GLYPHS[] FLASH = {')
+    body = source[source.index('{', start) + 1:source.index('};', start)]
+    data = [int(v) for v in re.findall(r'\b\d+\b', re.sub(r'/\*.*?\*/', '', body))]
+    glyphs = []
+    offsets = []
+    o = 0
+    while data[o]:
+        length = data[o] & 0x0f
+        top = (data[o] >> 4) - 1 if data[o] >> 4 else 4
+        text = bytes(data[o + 1:o + 1 + length])
+        size = data[o + length + 1]
+        bitmap = data[o + length + 2:o + length + 2 + (size & 0x7f)]
+        if size & 0x80:
+            columns = [bitmap[i] | bitmap[i + 1] << 8 for i in range(0, len(bitmap), 2)]
+        else:
+            columns = [b << top for b in bitmap]
+        glyphs.append((text, columns))
+        offsets.append(o)
+        o += length + (size & 0x7f) + 2
+    return glyphs, offsets
+
+
+def trim(columns):
+    while columns and not columns[0]:
+        columns = columns[1:]
+    while columns and not columns[-1]:
+        columns = columns[:-1]
+    return columns
+
+
+def encode(text, columns, compact):
+    ink = 0
+    for c in columns:
+        ink |= c
+    first = (ink & -ink).bit_length() - 1 if ink else 4
+    if len(text) > 15:
+        sys.exit('glyph texts can be at most 15 bytes')
+    if not ink >> 12 and not ink & 0x0f:
+        return [len(text)] + list(text) + [len(columns)] + [c >> 4 for c in columns]
+    if compact and not ink >> first >> 8:
+        top = min(first, 8)
+        return [(top + 1) << 4 | len(text)] + list(text) + [len(columns)] + [c >> top for c in columns]
+    if ink >> 16:
+        sys.exit('glyph %r is higher than 16 pixels' % text.decode('utf-8'))
+    if len(columns) > 63:
+        sys.exit('glyph %r is wider than 63 columns' % text.decode('utf-8'))
+    data = []
+    for c in columns:
+        data += [c & 0xff, c >> 8]
+    return [len(text)] + list(text) + [0x80 | len(data)] + data
+
+
+def comment(text):
+    s = text.decode('utf-8')
+    for a, b in (('\\', '\\\\'), ('"', '\\"'), ('\t', '\\t'), ('\x1b', '\\e')):
+        s = s.replace(a, b)
+    return '/* "%s" */' % s
+
+
+def table_offsets(glyphs, compact):
+    offsets = []
+    o = 0
+    for text, columns in glyphs:
+        offsets.append(o)
+        o += len(encode(text, columns, compact))
+    return offsets
+
+
+def write_table(glyphs, compact):
+    total = 1
+    for text, columns in glyphs:
+        data = encode(text, columns, compact)
+        total += len(data)
+        print('  %s %s,' % (comment(text), ', '.join(str(v) for v in data)))
+    print('  0')
+    print('%d glyphs, %d bytes' % (len(glyphs), total), file=sys.stderr)
+
+
+def write_index(glyphs, offsets):
+    if offsets[-1] > 0x7fff:
+        sys.exit('the table is too large for an index of shorts')
+    order = sorted(range(len(glyphs)), key=lambda i: glyphs[i][0])
+    for i in range(1, len(order)):
+        if glyphs[order[i]][0] == glyphs[order[i - 1]][0]:
+            sys.exit('glyph %r is in the table twice' % glyphs[order[i]][0].decode('utf-8'))
+    for i in range(0, len(order), 12):
+        print('  %s,' % ', '.join(str(offsets[j]) for j in order[i:i + 12]))
+    print('%d glyphs' % len(glyphs), file=sys.stderr)
+
+
+def write_stream(glyphs, name, height, space):
+    column_bytes = (height + 7) // 8
+    font = {}
+    for text, columns in glyphs:
+        s = text.decode('utf-8')
+        if len(s) != 1:
+            print('skipping glyph %r, stream fonts map single code points' % s, file=sys.stderr)
+            continue
+        if any(c >> height for c in columns):
+            sys.exit('glyph %r is higher than %d pixels' % (s, height))
+        if len(columns) > 255:
+            sys.exit('glyph %r is wider than 255 columns' % s)
+        font[ord(s)] = columns
+    codepoints = sorted(font)
+    ranges = []
+    for i, c in enumerate(codepoints):
+        if ranges and ranges[-1][0] + ranges[-1][1] == c and ranges[-1][1] < 0xffff:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([c, 1, i])
+    header = b'SF' + bytes([height, space]) + struct.pack('<HH', len(ranges), len(codepoints))
+    table = b''.join(struct.pack('<IHH', *r) for r in ranges)
+    offset = len(header) + len(table) + 4 * len(codepoints)
+    offsets = b''
+    data = b''
+    for c in codepoints:
+        offsets += struct.pack('<I', offset + len(data))
+        data += bytes([len(font[c])])
+        for column in font[c]:
+            data += column.to_bytes(column_bytes, 'little')
+    with open(name, 'wb') as f:
+        f.write(header + table + offsets + data)
+    print('%d glyphs in %d ranges, %d bytes' % (len(codepoints), len(ranges), len(header + table + offsets + data)),
+          file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', help='BDF, PNG or awakening.h file')
+    parser.add_argument('--baseline', type=int, default=10, help='row of the line below the baseline of a BDF font')
+    parser.add_argument('--cell', help='size of the cells of a PNG sheet, e.g. 6x8')
+    parser.add_argument('--chars', help='the text of the cells of a PNG sheet, row by row')
+    parser.add_argument('--top', type=int, help='row of the line where the cells of a PNG sheet start')
+    parser.add_argument('--invert', action='store_true', help='light pixels of a PNG are set')
+    parser.add_argument('--compact', action='store_true', help='one byte per column for glyphs fitting in 8 rows')
+    parser.add_argument('--index', action='store_true', help='write the index of the table instead of the table')
+    parser.add_argument('--stream', metavar='FILE', help='write a font for stream-font.h')
+    parser.add_argument('--height', type=int, default=16, help='height of the line of a stream font')
+    parser.add_argument('--space', type=int, default=3, help='width of a space in a stream font')
+    args = parser.parse_args()
+
+    name = args.input.lower()
+    if name.endswith('.png'):
+        if not args.cell or args.chars is None:
+            sys.exit('PNG sheets need --cell and --chars')
+        cell = tuple(int(v) for v in args.cell.split('x'))
+        top = args.top if args.top is not None else max(0, (16 - cell[1]) // 2)
+        glyphs = read_png(args.input, cell, args.chars, top, args.invert)
+    elif not name.endswith('.h'):
+        with open(args.input, encoding='latin-1') as f:
+            glyphs = read_bdf(f, args.baseline)
+    if name.endswith('.h'):
+        # Keep the glyphs of a table as they are, blank ones included.
+        with open(args.input, encoding='utf-8') as f:
+            glyphs, offsets = read_table(f)
+    else:
+        glyphs = [(text, trim(columns)) for text, columns in glyphs]
+        glyphs = [(text, columns) for text, columns in glyphs if columns]
+        offsets = table_offsets(glyphs, args.compact)
+
+    if args.index:
+        write_index(glyphs, offsets)
+    elif args.stream:
+        if not 0 < args.height <= 32:
+            sys.exit('stream fonts can be 1 to 32 pixels high')
+        write_stream(glyphs, args.stream, args.height, args.space)
+    else:
+        write_table(glyphs, args.compact)
+
+
+if __name__ == '__main__':
+    main()
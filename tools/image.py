@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Convert a PBM or PNG file into an image for image.h.
+
+Black pixels of a PBM become lit pixels. For a PNG dark, opaque pixels become lit
+pixels, use --invert for light ones. PNG files need Pillow.
+
+    tools/image.py logo.png logo > logo.h
+"""
+
+import argparse
+import sys
+
+
+def read_pbm(f):
+    data = f.read()
+    tokens = []
+    pos = 0
+
+    def token():
+        nonlocal pos
+        while True:
+            while pos < len(data) and data[pos:pos + 1].isspace():
+                pos += 1
+            if data[pos:pos + 1] == b'#':
+                while pos < len(data) and data[pos:pos + 1] != b'\n':
+                    pos += 1
+            else:
+                break
+        start = pos
+        while pos < len(data) and not data[pos:pos + 1].isspace():
+            pos += 1
+        return data[start:pos]
+
+    magic = token()
+    width = int(token())
+    height = int(token())
+    if magic == b'P1':
+        bits = [c == ord('1') for c in data[pos:] if c in b'01']
+        return width, height, [bits[y * width:(y + 1) * width] for y in range(height)]
+    if magic == b'P4':
+        pos += 1
+        stride = (width + 7) // 8
+        rows = []
+        for y in range(height):
+            row = data[pos + y * stride:pos + (y + 1) * stride]
+            rows.append([bool(row[x >> 3] >> (7 - (x & 7)) & 1) for x in range(width)])
+        return width, height, rows
+    raise ValueError('not a PBM file')
+
+
+def read_png(name, invert):
+    from PIL import Image
+    image = Image.open(name).convert('LA')
+    width, height = image.size
+    pixels = image.load()
+    rows = []
+    for y in range(height):
+        row = []
+        for x in range(width):
+            level, alpha = pixels[x, y]
+            row.append(alpha >= 128 and (level >= 128 if invert else level < 128))
+        rows.append(row)
+    return width, height, rows
+
+
+def pages(width, height, rows):
+    data = []
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and rows[y][x]:
+                    byte |= 1 << bit
+            data.append(byte)
+    return data
+
+
+def rle(data):
+    out = []
+    literal = []
+
+    def flush():
+        while literal:
+            chunk = literal[:128]
+            del literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    i = 0
+    while i < len(data):
+        n = 1
+        while i + n < len(data) and n < 128 and data[i + n] == data[i]:
+            n += 1
+        if n >= 3:
+            flush()
+            out.extend([0x80 | (n - 1), data[i]])
+            i += n
+        else:
+            literal.append(data[i])
+            i += 1
+    flush()
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', help='PBM or PNG file')
+    parser.add_argument('name', help='name of the C array')
+    parser.add_argument('--invert', action='store_true', help='light pixels of a PNG are lit')
+    compression = parser.add_mutually_exclusive_group()
+    compression.add_argument('--rle', action='store_true', help='always compress')
+    compression.add_argument('--raw', action='store_true', help='never compress')
+    args = parser.parse_args()
+
+    if args.input.lower().endswith('.png'):
+        width, height, rows = read_png(args.input, args.invert)
+    else:
+        with open(args.input, 'rb') as f:
+            width, height, rows = read_pbm(f)
+    if width > 255 or height > 255:
+        sys.exit('images can be at most 255 x 255 pixels')
+
+    data = pages(width, height, rows)
+    packed = rle(data)
+    compress = args.rle or (not args.raw and len(packed) < len(data))
+    body = packed if compress else data
+    values = [width, height, 1 if compress else 0] + body
+
+    print('// %s, %d x %d%s' % (args.input, width, height, ', RLE' if compress else ''))
+    print('static constexpr unsigned char %s[] FLASH = {' % args.name)
+    for i in range(0, len(values), 16):
+        print('  ' + ', '.join(str(v) for v in values[i:i + 16]) + ',')
+    print('};')
+
+
+if __name__ == '__main__':
+    main()